@@ -1,23 +1,58 @@
 #include <Wire.h> // Biblioteca para comunicar-se com circuitos inter-integrados
 #include <LiquidCrystal_I2C.h> // Biblioteca para mexer no LCD
+#include "Shared/Fixed_Point.h" // Conversões inteiras (o AVR não tem FPU)
+#define ADC_OVERSAMPLER_DEFINE_STATICS
+#include "Shared/Adc_Oversampler.h" // ADC por interrupção com sobreamostragem
+#define ALARM_ENGINE_DEFINE_STATICS
+#include "Shared/Alarm_Engine.h" // Alarme com histerese, buzzer e LED pelo Timer2
+#include "Shared/Lcd_Framebuffer.h" // Quadro do LCD em RAM (só envia o que mudou)
+#include "Shared/Cooperative_Scheduler.h" // Tarefas periódicas (CPU dormindo entre elas)
 #define LED 13 // Pino do LED
 #define BUZZER 8 // Pino do buzzer
 
 // Configuração do display LCD I2C
 // Endereço I2C: 0x27, 16 colunas, 2 linhas 
 LiquidCrystal_I2C lcd(0x27, 16, 2);
+LcdFramebuffer<LiquidCrystal_I2C, 16, 2> tela(lcd); // Menos tráfego no barramento I2C
 
 // Pino analógico onde o LM35 está conectado
 const int pinoLM35 = A0;
 
-// Variável para controlar se o buzzer deve estar ativo
-bool buzzerAtivo = false;
+// Sobreamostragem: 64 amostras por leitura = 13 bits efetivos,
+// uma conversão por tick do millis() (~977 Hz) = ~15 leituras por segundo
+const uint8_t bitsExtras = 3;
+
+// Temperaturas em centésimos de °C (inteiros em vez de float)
+const int16_t offsetSensor = 5000; // 500 mV em 0 °C
+const int16_t temperaturaAlerta = 4000; // 40,00 °C
+const int16_t temperaturaNormal = 3900; // 39,00 °C: o alerta só é desligado abaixo
+const uint16_t tempoConfirmacao = 2000; // Tempo mínimo além do limite (ms)
+
+// Alarme com histerese: não fica alternando perto dos 40 °C
+HysteresisAlarm alarmeTemperatura(temperaturaAlerta, temperaturaNormal, tempoConfirmacao);
+
+// Sinal do alarme (16 passos por ciclo), com escalonamento
+const AlarmPattern sinalAlerta[] = {
+    {0x0001, 0x00FF, 125, 4}, // Um bipe a cada 2 s, LED piscando (8 s)
+    {0x3333, 0x3333, 125, 4}, // Dois bipes por segundo (8 s)
+    {0xFFFF, 0xFFFF, 125, 0}  // Buzzer e LED contínuos
+};
+
+// O alerta é verificado a cada leitura; o LCD e o serial, a cada segundo
+const uint16_t intervaloExibicao = 1000;
+
+// Última leitura (exibida pela tarefa de exibição)
+uint16_t valorLM35 = 0;
+int16_t temperaturaC = 0;
+bool temLeitura = false;
+
+// Tarefas: leitura do ADC (a cada passada) e exibição (a cada segundo)
+CooperativeScheduler<2> agenda;
 
 void setup(){
 
-    // Define o pino do LED e do BUZZER
-    pinMode(LED, OUTPUT);
-    pinMode(BUZZER, OUTPUT);
+    // Define o pino do LED e do BUZZER (buzzer de 1 kHz gerado pelo Timer2, em vez do tone())
+    AlarmSignal::begin(BUZZER, LED, 1000);
 
     // Inicializa comunicação serial para debug
     Serial.begin(9600);
@@ -33,57 +68,67 @@ void setup(){
     lcd.print("Iniciando...");
     
     delay(2000); // Aguarda 2 segundos para mostrar a mensagem inicial
-    lcd.clear(); // Limpa o display
+    tela.setCursor(0, 0);
+    tela.print("Temperatura OK  ");
+    tela.flush(); // Primeiro envio: todas as células (limpa o display)
+
+    // Inicia as conversões do ADC em segundo plano
+    AdcOversampler::begin(pinoLM35, bitsExtras, AdcOversampler::Trigger::TIMER0_OVERFLOW);
+
+    agenda.addPolled(verificarTemperatura);
+    agenda.addPeriodic(exibirTemperatura, intervaloExibicao);
 }
 
 void loop(){
-    // Lê o valor do LM35
-    int valorLM35 = analogRead(pinoLM35);
+    // Executa as tarefas vencidas e dorme até a próxima interrupção
+    // (a conversão do ADC acorda a CPU ~977 vezes por segundo)
+    agenda.run();
+    agenda.idle();
+}
+
+void verificarTemperatura(){
+    // Lê o valor do LM35 (sem leitura nova, nada a fazer)
+    if (!AdcOversampler::read(valorLM35)) {
+        return;
+    }
     
-    // Converte o valor lido para temperatura em Celsius
-    float temperaturaC = (((valorLM35 * 5.0) / 1024.0) - 0.5) * 100.0; // Converte para Celsius (TMP35 fornece 10 mV/°C)
+    // Converte o valor lido para centésimos de °C (10 mV/°C, 1 LSB = 3125/64 centésimos em 10 bits)
+    temperaturaC = FixedPoint::adcToCentiCelsius(valorLM35, bitsExtras, offsetSensor);
+    temLeitura = true;
+
+    // O buzzer e o LED só mudam quando o alarme muda de estado
+    if (alarmeTemperatura.update(temperaturaC)) {
+        if (alarmeTemperatura.isActive()) {
+            AlarmSignal::play(sinalAlerta, 3);
+            Serial.println("Alerta: Alta T!");
+        } else {
+            AlarmSignal::stop();
+            Serial.println("Temperatura OK");
+        }
+
+        // Atualiza a mensagem do LCD
+        tela.setCursor(0, 0);
+        tela.print(alarmeTemperatura.isActive() ? "Alerta: Alta T! " : "Temperatura OK  ");
+        tela.flush();
+    }
+}
+
+void exibirTemperatura(){
+    // Nada a exibir antes da primeira leitura
+    if (!temLeitura) {
+        return;
+    }
 
     // Exibe a temperatura no monitor serial
-    Serial.print("Valor analógico no LM35: ");
+    Serial.print("Valor analógico no LM35 (13 bits): ");
     Serial.print(valorLM35);
     Serial.print("Temperatura: ");
-    Serial.print(temperaturaC, 1);
+    FixedPoint::printFixed(Serial, temperaturaC, 2);
     Serial.println(" °C");
 
     // Atualiza o display LCD com a temperatura
-    lcd.setCursor(0, 1);
-    lcd.print(temperaturaC, 1);
-    lcd.print(" C   "); // Espaços para limpar caracteres antigos
-
-    if (temperaturaC >= 40.0) {
-        // Se a temperatura for maior que 30°C, exibe alerta
-        lcd.setCursor(0, 0);
-        lcd.print("Alerta: Alta T! ");
-        Serial.println("Alerta: Alta T!");
-
-        // Pisca o LED
-        digitalWrite(LED, HIGH);
-
-        // Liga o buzzer continuamente
-        if (!buzzerAtivo){
-            tone(BUZZER, 1000); // Frequência de 1000Hz (1kHz)
-            buzzerAtivo = true;
-        }
-    } else {
-        // Limpa o alerta se a temperatura estiver normal
-        lcd.setCursor(0, 0);
-        lcd.print("Temperatura OK   ");
-        Serial.println("Temperatura OK");
-
-        // Desativa o LED
-        digitalWrite(LED, LOW);
-        
-        // Desliga o buzzer
-        if (buzzerAtivo){
-            noTone(BUZZER);
-            buzzerAtivo = false;
-        }
-    }
-
-    delay(1000); // Aguarda 1 segundo antes da próxima leitura
+    tela.setCursor(0, 1);
+    FixedPoint::printFixed(tela, temperaturaC, 2);
+    tela.print(" C   "); // Espaços para limpar caracteres antigos
+    tela.flush(); // Em geral, só os últimos dígitos
 }
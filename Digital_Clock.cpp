@@ -1,38 +1,62 @@
 #include <Wire.h>
-#include <DHT.h>
 #include <MD_Parola.h>
 #include <MD_MAX72xx.h>
 #include <SPI.h>
 
+// Included the background DHT22 acquisition (decoded by interrupt, cached)
+#define DHT_SENSOR_DEFINE_STATICS
+#include "Shared/Dht_Sensor.h"
+
+// Included the timebase (DS3231 or Timer1 1 Hz interrupt, epoch seconds)
+#define TIMEBASE_DEFINE_STATICS
+#include "Shared/Timebase.h"
+
+// Included the double-buffered message and the integer to ASCII writers
+#include "Shared/Message_Buffer.h"
+
 // Define hardware type for MAX7219 (assuming FC-16 module, generic matrix)
 #define HARDWARE_TYPE MD_MAX72XX::PAROLA_HW
 #define MAX_DEVICES 4 // Adjust this based on your matrix size (e.g., 4 for 32x8 display)
 
+// Zoned layout, opt-in with MAX_DEVICES 8 (up to 16): the time in a static
+// zone on the left modules, printed only when it changes; the date and
+// readings scroll in the other modules. Fewer modules (the 32x8 display):
+// everything scrolls in one zone, as before
+#define TIME_DEVICES 4 // "HH:MM" is 26 columns in the default font
+
+#if MAX_DEVICES >= 8
+#define ZONED_LAYOUT
+#define ZONE_INFO 0 // Modules 0 .. MAX_DEVICES - TIME_DEVICES - 1 (right side)
+#define ZONE_TIME 1 // The TIME_DEVICES modules on the left
+#endif
+
 // MAX7219 pins
 #define CLK_PIN 13
 #define DATA_PIN 11
 #define CS_PIN 10
 
-// DHT22 pin
+// DHT22 pin (must have an external interrupt: 2 or 3 on the Uno)
 #define DHT_PIN 2
-#define DHT_TYPE DHT22
+
+// Cached reading older than this is shown as unknown
+#define DHT_STALE_MS 30000UL
+
+// DS3231 SQW output pin (1 Hz, must have an external interrupt)
+#define RTC_SQW_PIN 3
 
 // Timezone offset for Brasília (UTC-3)
 #define TZ_OFFSET_SECONDS (-3 * 3600L)
 
 // ─── AJUSTE AQUI: hora inicial de Brasília ───────
+// (used without RTC, or when the RTC lost its time)
 #define START_HOUR   18
 #define START_MINUTE  0
 #define START_SECOND  0
 #define START_DAY     1
 #define START_MONTH   3   // 3 = Março, 4 = Abril, etc
 #define START_YEAR  2026
-#define START_DOW     0   // 0=Dom,1=Seg,2=Ter,3=Qua,4=Qui,5=Sex,6=Sab
 // ─────────────────────────────────────────────────
 
-// DHT
-DHT dht(DHT_PIN, DHT_TYPE);
-
 // Parola object for scrolling text
 MD_Parola P = MD_Parola(HARDWARE_TYPE, DATA_PIN, CLK_PIN, CS_PIN, MAX_DEVICES);
 
@@ -45,116 +69,230 @@ const char* months[] = {
     "Jul", "Ago", "Set", "Out", "Nov", "Dez"
 };
 
-// Days of month (no leap year)
-const uint8_t daysInMonth[] = {
-    31, 28, 31, 30, 31, 30,
-    31, 31, 30, 31, 30, 31
-};
+// Scrolling message: Parola shows the front buffer, fields are edited in
+// the back one and the buffers swap when a scroll pass has finished
+MessageBuffer<120> message;
+
+// Fixed-width fields of the message, rewritten in place
+#define TIME_WIDTH 8      // HH:MM:SS
+#define READING_WIDTH 5   // "-10.1", " 24.8", "100.0"
+
+uint8_t timeOffset = 0;
+uint8_t tempOffset = 0;
+uint8_t humOffset = 0;
 
-// Message buffer
-char message[120];
-unsigned long lastMillis = 0;
-
-// Clock state
-int8_t _sec, _min, _hour, _dow;
-uint8_t _day, _month;
-uint16_t _year;
-
-void tickClock() {
-    unsigned long now = millis();
-    unsigned long diff = (now - lastMillis) / 1000UL;
-    if (diff == 0) return;
-    lastMillis += diff * 1000UL;
-
-    _sec += diff;
-    while (_sec >= 60) { _sec -= 60; _min++; }
-    while (_min >= 60) { _min -= 60; _hour++; }
-    while (_hour >= 24) {
-        _hour -= 24;
-        _day++;
-        _dow = (_dow + 1) % 7;
-        uint8_t dim = daysInMonth[_month - 1];
-        if (_day > dim) {_day = 1; _month++; }
-        if (_month > 12) {_month = 1; _year++; }
+// What the back buffer shows (shownDay 0 = not rendered yet)
+uint8_t shownDay = 0;
+uint8_t shownMonth = 0;
+uint16_t shownYear = 0;
+bool shownValid = false;
+int16_t shownTemp = 0;
+uint16_t shownHum = 0;
+
+#ifdef ZONED_LAYOUT
+// Static zone text: printed at once (no animation), so a single buffer
+char clockText[6] = "--:--";
+uint16_t shownClock = 0xFFFF; // hour * 60 + minute
+#endif
+
+void writeTime(char* text, const Calendar& now) {
+    char* out = text + timeOffset;
+    out = TextFormat::writeUnsigned(out, now.hour, 2);
+    *out++ = ':';
+    out = TextFormat::writeUnsigned(out, now.minute, 2);
+    *out++ = ':';
+    TextFormat::writeUnsigned(out, now.second, 2);
+}
+
+// Last good reading; a failed reading keeps it, an old one is shown as unknown
+void writeReadings(char* text) {
+    if (shownValid) {
+        TextFormat::writeTenths(text + tempOffset, shownTemp, READING_WIDTH);
+        TextFormat::writeTenths(text + humOffset, shownHum, READING_WIDTH);
+    } else {
+        TextFormat::writePadded(text + tempOffset, "--.-", READING_WIDTH);
+        TextFormat::writePadded(text + humOffset, "--.-", READING_WIDTH);
     }
 }
 
-int correctTimeZone(int UTChour) {
-    int h = UTChour + TZ_OFFSET_SECONDS;
-    if (h < 0) h += 24;
-    if (h >= 24) h -= 24;
-    return h;
+// Whole message (the date and day name have variable length): once a day
+// " HH:MM:SS  |  DD Mon YYYY  |  Day  |  Temp: 24.8C  |  Umid: 65.2% "
+// (without "HH:MM:SS  |  " in the zoned layout, the time has its own zone)
+void renderMessage(char* text, const Calendar& now) {
+    char* out = text;
+
+    *out++ = ' ';
+#ifndef ZONED_LAYOUT
+    timeOffset = out - text;
+    out += TIME_WIDTH;
+    out = TextFormat::writeText(out, "  |  ");
+#endif
+    out = TextFormat::writeUnsigned(out, now.day, 2);
+    *out++ = ' ';
+    out = TextFormat::writeText(out, months[now.month - 1]);
+    *out++ = ' ';
+    out = TextFormat::writeUnsigned(out, now.year, 4);
+
+    out = TextFormat::writeText(out, "  |  ");
+    out = TextFormat::writeText(out, daysOfWeek[now.dayOfWeek]);
+
+    out = TextFormat::writeText(out, "  |  Temp:");
+    tempOffset = out - text;
+    out += READING_WIDTH;
+
+    out = TextFormat::writeText(out, "C  |  Umid:");
+    humOffset = out - text;
+    out += READING_WIDTH;
+
+    out = TextFormat::writeText(out, "% ");
+    *out = '\0';
+
+#ifndef ZONED_LAYOUT
+    writeTime(text, now);
+#endif
+    writeReadings(text);
+}
+
+#ifdef ZONED_LAYOUT
+// Checked once per second; the zone is printed again only when HH:MM changed
+void updateClockZone(const Calendar& now) {
+    const uint16_t clock = now.hour * 60 + now.minute;
+    if (clock == shownClock) {
+        return;
+    }
+    shownClock = clock;
+
+    char* out = TextFormat::writeUnsigned(clockText, now.hour, 2);
+    *out++ = ':';
+    TextFormat::writeUnsigned(out, now.minute, 2);
+
+    P.displayReset(ZONE_TIME);
+}
+#endif
+
+// Bring the back buffer up to date, rewriting only the fields that changed
+// Returns false if the text is the same
+bool updateMessage(const Calendar& now, bool newSecond) {
+    const bool valid = DhtSensor::hasValue() && DhtSensor::getAgeMillis() < DHT_STALE_MS;
+    const int16_t temp = DhtSensor::getTemperatureDeci();
+    const uint16_t hum = DhtSensor::getHumidityDeci();
+    const bool newReadings = valid != shownValid ||
+                             (valid && (temp != shownTemp || hum != shownHum));
+    const bool newDate = now.day != shownDay || now.month != shownMonth || now.year != shownYear;
+
+#ifdef ZONED_LAYOUT
+    const bool newTime = false; // Not in the message
+    (void)newSecond;
+#else
+    const bool newTime = newSecond;
+#endif
+
+    if (!newDate && !newTime && !newReadings) {
+        return false;
+    }
+
+    shownValid = valid;
+    shownTemp = temp;
+    shownHum = hum;
+
+    char* text = message.edit();
+
+    if (newDate) {
+        renderMessage(text, now);
+        shownDay = now.day;
+        shownMonth = now.month;
+        shownYear = now.year;
+        return true;
+    }
+
+    if (newTime) {
+        writeTime(text, now);
+    }
+    if (newReadings) {
+        writeReadings(text);
+    }
+    return true;
 }
 
 void setup() {
     Serial.begin(9600); // For debugging
 
-    // Inicializa estado do relógio
-    _sec   = START_SECOND;
-    _min   = START_MINUTE;
-    _hour  = START_HOUR;
-    _day   = START_DAY;
-    _month = START_MONTH;
-    _year  = START_YEAR;
-    _dow   = START_DOW;
-    lastMillis = millis();
+    // Inicializa o relógio: DS3231 se presente, senão Timer1
+    if (!Timebase::beginDs3231(RTC_SQW_PIN)) {
+        Serial.println("DS3231 nao encontrado, usando Timer1");
+        Timebase::beginTimer1();
+    }
+    Timebase::setTimeZone(TZ_OFFSET_SECONDS);
+
+    if (!Timebase::isTimeValid()) {
+        // START_* is the local time of Brasília: converted to UTC
+        Calendar start;
+        start.year   = START_YEAR;
+        start.month  = START_MONTH;
+        start.day    = START_DAY;
+        start.hour   = START_HOUR;
+        start.minute = START_MINUTE;
+        start.second = START_SECOND;
+        Timebase::setTime(Timebase::fromCalendar(start) - TZ_OFFSET_SECONDS);
+    }
 
-    // Initialize DHT
-    dht.begin();
+    // Initialize DHT (first reading in background ~1 s later)
+    if (!DhtSensor::begin(DHT_PIN)) {
+        Serial.println("Pino do DHT sem interrupcao externa!");
+    }
 
     // Initialize Parola
+#ifdef ZONED_LAYOUT
+    P.begin(2);
+    P.setZone(ZONE_INFO, 0, MAX_DEVICES - TIME_DEVICES - 1);
+    P.setZone(ZONE_TIME, MAX_DEVICES - TIME_DEVICES, MAX_DEVICES - 1);
+#else
     P.begin();
+#endif
     P.setIntensity(8); // Brightness 0-15
     P.displayClear();
-    strcpy(message, "Iniciando..."); // Initial message
-    P.displayText(message, PA_LEFT, 50, 0, PA_SCROLL_LEFT, PA_SCROLL_LEFT); // Optional, can be LEFT, RIGHT, CENTER
+    strcpy(message.edit(), "Iniciando..."); // Initial message
+    message.swapIfDirty();
+#ifdef ZONED_LAYOUT
+    P.displayZoneText(ZONE_INFO, message.front(), PA_LEFT, 50, 0, PA_SCROLL_LEFT, PA_SCROLL_LEFT);
+    P.displayZoneText(ZONE_TIME, clockText, PA_CENTER, 0, 0, PA_PRINT, PA_NO_EFFECT);       // Static
+#else
+    P.displayText(message.front(), PA_LEFT, 50, 0, PA_SCROLL_LEFT, PA_SCROLL_LEFT); // Optional, can be LEFT, RIGHT, CENTER
+#endif
 }
   
 void loop() {
-    tickClock(); 
-    
-    // Read DHT22
-    float humidity = dht.readHumidity();
-    float temperature = dht.readTemperature();
-
-    // Check if readings failed
-    if (isnan(humidity) || isnan(temperature)){
-        Serial.println("Falha em ler do sensor DHT!");
-        delay(2000);
-        return;
-    }
-
-    // Format strings
-    char timeStr[10];
-    sprintf(timeStr, "%02d:%02d:%02d", _hour, _min, _sec);
-
-    char dateStr[20];
-    sprintf(dateStr, "%02d %s %04d", _day, months[_month - 1], _year);
+    // Advance the DHT22 acquisition (never waits for the sensor)
+    DhtSensor::service();
 
-    const char* dayStr = daysOfWeek[_dow];
+    // Local time, broken down only when the second changed
+    const bool newSecond = Timebase::secondChanged();
+    const Calendar& now = Timebase::localTime();
 
-    // Transfroming temperature and humidity in strings
-    char tempBuff[8], humBuff[8];
-    dtostrf(temperature, 4, 1, tempBuff);
-    dtostrf(humidity, 4, 1, humBuff);
-    
-    char tempStr[16];
-    sprintf(tempStr, "Temp: %sC", tempBuff);
-
-    char humStr[16];
-    sprintf(humStr, "Umid: %s%%", humBuff);
+#ifdef ZONED_LAYOUT
+    if (newSecond) {
+        updateClockZone(now);
+    }
+#endif
 
-    sprintf(message, " %s  |  %s  |  %s  |  %s  |  %s ",
-            timeStr, dateStr, dayStr, tempStr, humStr); 
+    if (updateMessage(now, newSecond)) {
+        Serial.println(message.latest()); // For debugging (only when it changed)
+    }
 
-    Serial.println(message); // For debugging
-    
-    // Display scrolling text
+    // Display scrolling text: the new text is shown from the next pass,
+    // never in the middle of a scroll
+    // (zoned: displayAnimate() is true as soon as any zone is done, and the
+    // static zone always is; only the end of the scrolling zone counts)
     if (P.displayAnimate()) {
-        P.displayText(message, PA_LEFT, 50, 0, PA_SCROLL_LEFT, PA_SCROLL_LEFT); // Speed 50, scroll left
+#ifdef ZONED_LAYOUT
+        if (P.getZoneStatus(ZONE_INFO)) {
+            message.swapIfDirty();
+            P.setTextBuffer(ZONE_INFO, message.front());
+            P.displayReset(ZONE_INFO);
+        }
+#else
+        message.swapIfDirty();
+        P.displayText(message.front(), PA_LEFT, 50, 0, PA_SCROLL_LEFT, PA_SCROLL_LEFT); // Speed 50, scroll left
+#endif
     }
-
-    delay(100); //Small delay to avoid overwhelming the loop
 }
-
-
@@ -6,6 +6,7 @@
 #include <Adafruit_FT6206.h>
 #include <avr/sleep.h>
 #include <avr/power.h>
+#include "Shared/Event_Dispatcher.h"
 
 #pragma GCC optimize ("Os") // Otimização para código compacto e eficiente
 
@@ -14,10 +15,16 @@
 // ─────────────────────────────────────────────────────────────
 constexpr uint8_t TFT_CS = 10;
 constexpr uint8_t TFT_DC = 9;
+constexpr uint8_t TOUCH_INT_PIN = 2; // INT do FT6206 (INT0: acorda do power-down)
+constexpr uint8_t TFT_BACKLIGHT_PIN = 6; // LED do TFT (PWM)
+constexpr uint8_t BACKLIGHT_FULL = 255;
+constexpr uint8_t BACKLIGHT_DIM = 24;
 constexpr uint16_t SCREEN_W = 320;
 constexpr uint16_t SCREEN_H = 240;
 constexpr uint16_t BOXSIZE = 40; // Tamanho de cada dor na paleta
 constexpr uint16_t PENRADIUS = 3; // Espessura do pincel
+constexpr uint16_t DRAW_TOP = BOXSIZE + 1; // Primeira linha da área de desenho
+constexpr uint32_t STROKE_GAP_MS = 60; // Sem toque por mais tempo = caneta levantada
 
 // Paleta de cores (8 blocos iguais)
 constexpr uint16_t PALETTE[] = {
@@ -32,79 +39,241 @@ constexpr uint8_t NUM_COLORS = sizeof(PALETTE) / sizeof(PALETTE[0]);
 struct AppState {
     uint16_t currentColor = ILI9341_RED;
     uint32_t lastTouchMs = 0;
+    uint32_t lastStrokeMs = 0; // Último ponto tratado pelo desenho
+    bool wakeTouch = false; // Toque que acordou o sistema (não desenha)
     uint8_t selectedIdx = 0;
 } appState;
 
 // ─────────────────────────────────────────────────────────────
-//  EVENT DISPATCHER (Pub-Sub circular, lock-free)
+//  EVENTOS (Pub-Sub circular, payload copiado na fila)
 // ─────────────────────────────────────────────────────────────
-enum class EventType : uint8_t { SYSTEM_INIT, TOUCH_EVENT, IDLE_TIMEOUT };
-using EventCallback = void (*)(const void*);
+enum class EventType : uint8_t { SYSTEM_INIT, TOUCH_EVENT, IDLE_TIMEOUT, COUNT };
+constexpr uint8_t EVENT_TYPES = static_cast<uint8_t>(EventType::COUNT);
 
-class EventDispatcher {
-public:
-    static constexpr uint8_t MAX_SUBS = 5;
-    static constexpr uint8_t QUEUE_SIZE = 10;
+// Payloads pequenos, copiados para dentro do evento (nenhum ponteiro para a pilha)
+struct TouchPayload { int16_t x, y; uint32_t timeMs; };
 
-    void subscribe(EventType type, EventCallback cb) noexcept {
-        for (auto& s : subs_) {
-            if (!s.cb) { s.type = type; s.cb = cb; return; }
-        }
-    }
-
-    void publish(EventType type, const void* payload = nullptr) noexcept {
-        uint8_t next = (tail_ + 1) % QUEUE_SIZE;
-        if (next == head_) return; // Fila cheia: descarta evento antigo
-        queue_[tail_] = {type, payload};
-        tail_ = next;
-    }
+struct Event {
+    EventType type;
+    union {
+        TouchPayload touch; // TOUCH_EVENT
+    };
+};
 
-    void process() noexcept {
-        while (head_ != tail_) {
-            const auto& evt = queue_[head_];
-            head_ = (head_ + 1) % QUEUE_SIZE;
-            for (const auto& s: subs_) {
-                if (s.type == evt.type && s.cb) s.cb(evt.payload);
-            }
-        }
-    }
+// Subscribers indexados por tipo (despacho O(1)), fila potência de 2 (máscara)
+constexpr uint8_t MAX_SUBS_PER_TYPE = 2;
+constexpr uint8_t QUEUE_SIZE = 16;
+EventDispatcher<Event, EVENT_TYPES, MAX_SUBS_PER_TYPE, QUEUE_SIZE> dispatcher;
 
-private:
-    struct Subscriber { EventType type{EventType::SYSTEM_INIT}; EventCallback cb{nullptr}; };
-    struct Event { EventType type; const void* payload; };
-    Subscriber subs_[MAX_SUBS]{};
-    Event queue_[QUEUE_SIZE];
-    uint8_t head_{0}, tail_{0};
-} dispatcher;
+// ─────────────────────────────────────────────────────────────
+//  PERIFÉRICOS (Alocação estática para evitar fragmentação de RAM)
+// ─────────────────────────────────────────────────────────────
+Adafruit_ILI9341 tft(TFT_CS, TFT_DC);
+Adafruit_FT6206 touch; // I2C, não usa CS
 
 // ─────────────────────────────────────────────────────────────
 //  GERENCIAMENTO DE CLOCK & POWER (RAII-style)
 // ─────────────────────────────────────────────────────────────
+// Escala: idle (CPU descansa) -> backlight reduzido -> power-down com o
+// backlight e o painel desligados, acordando pelo INT do touch
+volatile bool touchSignaled = false; // Marcado pelo INT do FT6206
+
+void onTouchInterrupt() { touchSignaled = true; }
+
 class PowerManager {
 public:
+    static constexpr uint32_t IDLE_SLEEP_MS = 2000;
+    static constexpr uint32_t DIM_MS = 15000;
+    static constexpr uint32_t POWER_DOWN_MS = 60000;
+
     static void init() noexcept {
         // Clock full (16MHz). Prescaler padrão do bootloader já é div_1.
         clock_prescale_set(clock_div_1);
-        set_sleep_mode(SLEEP_MODE_IDLE); // CPU descansa, mas SPI/I2C/INTs ativos
+        pinMode(TFT_BACKLIGHT_PIN, OUTPUT);
+        setBacklight(BACKLIGHT_FULL);
     }
-    
-    static void sleepIfIdle(uint32_t lastActivity, uint32_t now) noexcept {
-       if (now - lastActivity > 2000) {
-          sleep_enable(); sei(); sleep_cpu(); sleep_disable();  
-       }
+
+    // Retorna true se acordou de um power-down (toque de despertar)
+    static bool sleepIfIdle(uint32_t lastActivity, uint32_t now) noexcept {
+        const uint32_t idle = now - lastActivity;
+
+        if (idle > POWER_DOWN_MS) {
+            powerDown();
+            return true;
+        }
+        if (idle > DIM_MS) setBacklight(BACKLIGHT_DIM);
+
+        if (idle > IDLE_SLEEP_MS) {
+            set_sleep_mode(SLEEP_MODE_IDLE); // CPU descansa, mas SPI/I2C/INTs ativos
+            sleep_enable(); sei(); sleep_cpu(); sleep_disable();
+        }
+        return false;
+    }
+
+    static void onActivity() noexcept {
+        if (backlight_ != BACKLIGHT_FULL) setBacklight(BACKLIGHT_FULL);
+    }
+
+private:
+    static uint8_t backlight_;
+
+    static void setBacklight(uint8_t level) noexcept {
+        backlight_ = level;
+        analogWrite(TFT_BACKLIGHT_PIN, level);
+    }
+
+    // No power-down só o nível LOW do INT0 acorda (a borda precisa do clock de I/O)
+    static void onWake() { detachInterrupt(digitalPinToInterrupt(TOUCH_INT_PIN)); }
+
+    static void powerDown() noexcept {
+        digitalWrite(TFT_BACKLIGHT_PIN, LOW); // PWM para no power-down: desliga de vez
+        tft.sendCommand(ILI9341_SLPIN);
+
+        const uint8_t adcsra = ADCSRA;
+        ADCSRA &= ~_BV(ADEN); // ADC desligado durante o sono
+
+        set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+        cli();
+        detachInterrupt(digitalPinToInterrupt(TOUCH_INT_PIN));
+        attachInterrupt(digitalPinToInterrupt(TOUCH_INT_PIN), onWake, LOW);
+        sleep_enable();
+#if defined(sleep_bod_disable)
+        sleep_bod_disable();
+#endif
+        sei(); sleep_cpu(); // sei() garante o sleep_cpu() antes de uma interrupção pendente
+        sleep_disable();
+
+        ADCSRA = adcsra;
+        attachInterrupt(digitalPinToInterrupt(TOUCH_INT_PIN), onTouchInterrupt, FALLING);
+
+        tft.sendCommand(ILI9341_SLPOUT);
+        delay(5); // ILI9341: 5 ms após SLPOUT antes do próximo comando
+        setBacklight(BACKLIGHT_FULL);
     }
 };
 
+uint8_t PowerManager::backlight_ = BACKLIGHT_FULL;
+
 // ─────────────────────────────────────────────────────────────
-//  PERIFÉRICOS (Alocação estática para evitar fragmentação de RAM)
+//  RENDERIZADOR DE TRAÇOS (linha espessa + spans em rajada SPI)
 // ─────────────────────────────────────────────────────────────
-Adafruit_ILI9341 tft(TFT_CS, TFT_DC);
-Adafruit_FT6206 touch; // I2C, não usa CS
+// Liga cada ponto ao anterior com uma linha de Bresenham espessa e ponta
+// redonda. Os pixels saem como retângulos (spans vizinhos de mesma
+// extensão são fundidos): uma janela de endereço + writeColor por span,
+// tudo dentro de um único startWrite()/endWrite() por segmento.
+class StrokeRenderer {
+public:
+    void penUp() noexcept { active_ = false; }
+
+    void drawTo(int16_t x, int16_t y, uint16_t color) noexcept {
+        color_ = color;
+        tft.startWrite();
+
+        if (active_) {
+            thickLine(lastX_, lastY_, x, y);
+        }
+        cap(x, y); // Ponta redonda (ou ponto isolado no início do traço)
+
+        flushSpan();
+        tft.endWrite();
+
+        lastX_ = x;
+        lastY_ = y;
+        active_ = true;
+    }
+
+private:
+    struct Span { int16_t x, y, w, h; };
+
+    Span pending_{0, 0, 0, 0};
+    int16_t lastX_ = 0, lastY_ = 0;
+    uint16_t color_ = 0;
+    bool active_ = false;
+
+    static uint16_t isqrt(uint32_t value) noexcept {
+        uint32_t root = 0, bit = 1UL << 30;
+        while (bit > value) bit >>= 2;
+        while (bit) {
+            if (value >= root + bit) { value -= root + bit; root = (root >> 1) + bit; }
+            else root >>= 1;
+            bit >>= 2;
+        }
+        return root;
+    }
+
+    void flushSpan() noexcept {
+        if (pending_.w > 0 && pending_.h > 0) {
+            tft.setAddrWindow(pending_.x, pending_.y, pending_.w, pending_.h);
+            tft.writeColor(color_, static_cast<uint32_t>(pending_.w) * pending_.h);
+        }
+        pending_.w = 0;
+    }
+
+    // Recorta à área de desenho e funde com o span pendente se possível
+    void addSpan(int16_t x, int16_t y, int16_t w, int16_t h) noexcept {
+        if (x < 0) { w += x; x = 0; }
+        if (y < static_cast<int16_t>(DRAW_TOP)) { h -= DRAW_TOP - y; y = DRAW_TOP; }
+        if (x + w > static_cast<int16_t>(SCREEN_W)) w = SCREEN_W - x;
+        if (y + h > static_cast<int16_t>(SCREEN_H)) h = SCREEN_H - y;
+        if (w <= 0 || h <= 0) return;
+
+        if (pending_.w > 0) {
+            if (y == pending_.y && h == pending_.h && x == pending_.x + pending_.w) {
+                pending_.w += w; // Coluna vizinha de mesma altura
+                return;
+            }
+            if (x == pending_.x && w == pending_.w && y == pending_.y + pending_.h) {
+                pending_.h += h; // Linha vizinha de mesma largura
+                return;
+            }
+            flushSpan();
+        }
+        pending_ = {x, y, w, h};
+    }
+
+    void cap(int16_t cx, int16_t cy) noexcept {
+        constexpr int16_t r = PENRADIUS;
+        for (int16_t dy = -r; dy <= r; ++dy) {
+            int16_t half = r;
+            while (half * half + dy * dy > r * r) --half;
+            addSpan(cx - half, cy + dy, 2 * half + 1, 1);
+        }
+    }
+
+    // Bresenham no eixo principal; em cada passo, um span perpendicular
+    // com a meia-espessura corrigida pela inclinação (r * L / eixo principal)
+    void thickLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1) noexcept {
+        const int16_t dx = abs(x1 - x0), dy = abs(y1 - y0);
+        const int16_t sx = x0 < x1 ? 1 : -1, sy = y0 < y1 ? 1 : -1;
+        const uint16_t length = isqrt(static_cast<uint32_t>(dx) * dx + static_cast<uint32_t>(dy) * dy);
+        const bool horizontal = dx >= dy;
+        const int16_t major = horizontal ? dx : dy;
+        if (major == 0) return;
+
+        const int16_t half = (static_cast<uint32_t>(PENRADIUS) * length + major / 2) / major;
+        int16_t err = (horizontal ? dx : -dy) / 2;
+
+        for (int16_t i = 0; i <= major; ++i) {
+            if (horizontal) addSpan(x0, y0 - half, 1, 2 * half + 1);
+            else addSpan(x0 - half, y0, 2 * half + 1, 1);
+
+            if (horizontal) {
+                x0 += sx;
+                err -= dy;
+                if (err < 0) { y0 += sy; err += dx; }
+            } else {
+                y0 += sy;
+                err += dx;
+                if (err > 0) { x0 += sx; err -= dy; }
+            }
+        }
+    }
+} stroke;
 
 // ─────────────────────────────────────────────────────────────
 //  HANDLERS (Stateless, noexcept, C++ moderno)
 // ─────────────────────────────────────────────────────────────
-void onInit([[maybe_unused]] const void*) noexcept {
+void onInit([[maybe_unused]] const Event&) noexcept {
     tft.begin();
     tft.setRotation(1); // 320x240 landscape
     tft.fillScreen(ILI9341_WHITE);
@@ -122,17 +291,22 @@ void onInit([[maybe_unused]] const void*) noexcept {
     tft.println("Toque para desenhar");
 }
 
-void onTouchEvent(const void* data) noexcept {
-   const auto& pt = static_cast<const TS_Point*>(data);
+void onTouchEvent(const Event& evt) noexcept {
+   const TouchPayload& pt = evt.touch;
 
    // ── MAPEAMENTO CORRETO (igual ao código funcional) ──
     // FT6206 retorna coordenadas com eixos invertidos em relação à tela
-   int16_t x = map(pt->x, 0, 240, 240, 0); // Inverte X
-   int16_t y = map(pt->y, 0, 320, 320, 0); // Inverte Y
+   int16_t x = map(pt.x, 0, 240, 240, 0); // Inverte X
+   int16_t y = map(pt.y, 0, 320, 320, 0); // Inverte Y
    x = constrain(x, 0, SCREEN_W - 1);
    y = constrain(y, 0, SCREEN_H - 1);
 
+   // Intervalo sem toque: novo traço (não liga ao ponto anterior)
+   if (pt.timeMs - appState.lastStrokeMs > STROKE_GAP_MS) stroke.penUp();
+   appState.lastStrokeMs = pt.timeMs;
+
    if (y < BOXSIZE) {
+        stroke.penUp();
         // Seleção de cor
         uint8_t idx = x / BOXSIZE;
         if (idx < NUM_COLORS && idx != appState.selectedIdx) {
@@ -147,13 +321,18 @@ void onTouchEvent(const void* data) noexcept {
     } 
     else if ((y - PENRADIUS) > BOXSIZE && (y + PENRADIUS) < SCREEN_H) {
        // ── ÁREA DE DESENHO ──
-       // Desenha círculo simples 
-       tft.fillCircle(x, y, PENRADIUS, appState.currentColor);
+       // Linha espessa desde o ponto anterior, em spans
+       stroke.drawTo(x, y, appState.currentColor);
    }
 }
 
-void onIdle([[maybe_unused]] const void*) noexcept {
-    PowerManager::sleepIfIdle(appState.lastTouchMs, millis());
+void onIdle([[maybe_unused]] const Event&) noexcept {
+    if (PowerManager::sleepIfIdle(appState.lastTouchMs, millis())) {
+        // Acordou pelo toque: reinicia a contagem e ignora até soltar o dedo
+        appState.lastTouchMs = millis();
+        appState.wakeTouch = true;
+        stroke.penUp();
+    }
 }
 
 // ─────────────────────────────────────────────────────────────
@@ -174,10 +353,16 @@ void setup() {
     tft.begin();
     if (!touch.begin(10)) while (true) {  /* Falha crítica */ }
 
-    // Registro de subscribers
-    dispatcher.subscribe(EventType::SYSTEM_INIT, onInit);
-    dispatcher.subscribe(EventType::TOUCH_EVENT, onTouchEvent);
-    dispatcher.subscribe(EventType::IDLE_TIMEOUT, onIdle);
+    // INT do touch: o I2C só é lido quando o controlador sinaliza
+    pinMode(TOUCH_INT_PIN, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(TOUCH_INT_PIN), onTouchInterrupt, FALLING);
+
+    // Registro de subscribers (capacidade excedida = falha de configuração)
+    bool subscribed = dispatcher.subscribe(EventType::SYSTEM_INIT, onInit);
+    subscribed &= dispatcher.subscribe(EventType::TOUCH_EVENT, onTouchEvent);
+    subscribed &= dispatcher.subscribe(EventType::IDLE_TIMEOUT, onIdle);
+    if (!subscribed) while (true) {  /* Falha crítica */ }
+    dispatcher.setCoalescing(EventType::IDLE_TIMEOUT, true); // Publicado a cada volta do loop
 
     // Dispara evento de boot
     dispatcher.publish(EventType::SYSTEM_INIT);
@@ -187,16 +372,26 @@ void loop() {
     // 1. Processa fila de eventos (zero delay, zero bloqueio)
     dispatcher.process();
 
-    // 2. Polling não-bloqueante de touch (limitado a 30Hz para evitar flood)
+    // 2. Touch por interrupção: no modo padrão do FT6206 o INT fica em LOW
+    //    enquanto há dedo na tela; sem toque, nenhuma leitura I2C
     static uint32_t lastTouch = 0;
-    if (millis() - lastTouch >= 16) { // ~60Hz para desenho fluido 
+    const bool touchLow = digitalRead(TOUCH_INT_PIN) == LOW;
+    if ((touchSignaled || touchLow) && millis() - lastTouch >= 16) { // ~60Hz para desenho fluido 
         lastTouch = millis();
+        touchSignaled = false;
         if (touch.touched()) {
-            TS_Point p = touch.getPoint();
-            dispatcher.publish(EventType::TOUCH_EVENT, &p);
+            if (!appState.wakeTouch) {
+                TS_Point p = touch.getPoint();
+                Event evt;
+                evt.type = EventType::TOUCH_EVENT;
+                evt.touch = {p.x, p.y, millis()};
+                dispatcher.publish(evt);
+            }
             appState.lastTouchMs = millis();
+            PowerManager::onActivity();
         }
     }
+    if (appState.wakeTouch && !touchLow) appState.wakeTouch = false; // Dedo solto
 
     // 3. Power Management: entra em idle quando não há eventos pendentes
     dispatcher.publish(EventType::IDLE_TIMEOUT);
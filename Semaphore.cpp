@@ -16,111 +16,51 @@
  */
 
 #include <U8x8lib.h>
+#include <avr/sleep.h>
 
-// Definição dos pinos dos LEDs 
+// Mesmo núcleo da versão com FreeRTOS: tabela de estados em PROGMEM
+// (StateTable/LedConfiguration), HAL e máquina de estados. Os pinos e as
+// durações ficam em Semaphore_RTOS/Config.h (HardwareConfig, TimingConfig)
+#define SEMAPHORE_STATIC_ALLOCATION 1 // Sem heap: o controlador é estático
+#include "Semaphore_RTOS/Semaphore_State_Machine.h"
 
-const int ledRedCar = 13;
-const int ledYellowCar = 12;
-const int ledGreenCar = 11;
-const int ledGreenPedestrian = 10;
-const int ledRedPedestrian = 9;
+using namespace SemaphoreSystem;
 
-// Variáveis de controle de tempo
-unsigned long previousMillis = 0; // Armazena o último tempo registrado
-unsigned long currentMillis = 0; // Tempo atual
-int currentState = 0; // Estado atual do semáforo (0-4)
-
-// Definição dos tempos para cada estado (em milissegundos)
-const unsigned long STATE_DURATIONS[] = {
-  20000, // Estado 0: Verde carro (20s)
-  3000,  // Estado 1: Amarelo carro (3s)
-  5000,  // Estado 2: Vermelho carro + Vermelho pedestre (5s - diferença)
-  20000, // Estado 3: Verde pedestre (20s)
-  5000   // Estado 4: Vermelho carro + Vermelho pedestre (5s - diferença)
-};
+// Controle dos LEDs: uma configuração inteira por escrita (sem apagar todos)
+ArduinoHardwareController& hardware = ArduinoHardwareController::getInstance();
+SemaphoreStateMachine semaphore(hardware);
 
 void setup() {
-  // Configuração dos pinos como saída
-  pinMode(ledRedCar, OUTPUT);
-  pinMode(ledYellowCar, OUTPUT);
-  pinMode(ledGreenCar, OUTPUT);
-  pinMode(ledGreenPedestrian, OUTPUT);
-  pinMode(ledRedPedestrian, OUTPUT);
-
-  // Inicialização do sistema
-  previousMillis = millis();
-  currentState = 0;
-
   // Inicialização serial para debug (opcional)
   Serial.begin(9600);
+  Logger::begin(Serial); // Sem dreno: as linhas são escritas diretamente
+
+  // Configura os pinos como saída, todos desligados, e aplica o estado 0
+  semaphore.initialize();
+  semaphore.begin();
+
   Serial.println("Sistema de Semáforo Iniciado");
 }
 
 void loop(){
- currentMillis = millis();
-
- // Verifica se é hora de mudar de estado
- if (currentMillis - previousMillis >= STATE_DURATIONS[currentState]){
-  // Avança para o próximo estado
-  currentState = (currentState + 1) % 5; // Cicla entre os estados de 0 a 4
-  previousMillis = currentMillis; // Atualiza o tempo do último estado
-
-  // Debug - mostra mudança de estado
-  Serial.print("Mudando para o estado: ");
-  Serial.println(currentState);
- }
- // Controla os LEDs baseado no estado atual
- controlSemaphore(currentState);
+  // Os LEDs só são escritos na transição de estado (registrada no serial)
+  semaphore.update();
+
+  // Dorme até o prazo do estado atual: cada interrupção do Timer0
+  // (~1 ms) acorda a CPU só para comparar o tempo restante
+  while (semaphore.getTimeRemainingInState() > 0) {
+    sleepUntilNextInterrupt();
+  }
 }
 
 /**
- * Função que controla os LEDs baseado no estado atual
- * @param state - Estado atual do semáforo (0-4)
+ * Modo IDLE: a CPU para, os timers e a serial continuam funcionando
  */
-
-void controlSemaphore(int state){
-
-  // Desliga todos os LEDs antes de definir o novo estado
-  turnAllLEDSOff();
-
-  // Liga os LEDs de acordo com o estado atual
-  switch (state) {
-      case 0: // Verde para carros, vermelho para pedestres
-        digitalWrite(ledGreenCar, HIGH);
-        digitalWrite(ledRedPedestrian, HIGH);
-        break;
-
-      case 1: // Amarelo para carros, vermelho para pedestres
-        digitalWrite(ledYellowCar, HIGH);;
-        digitalWrite(ledRedPedestrian, HIGH);
-        break;
-        
-      case 2: // Vermelho para carros, vermelho para pedestres (diferença de 5s)
-        digitalWrite(ledRedCar, HIGH);
-        digitalWrite(ledRedPedestrian, HIGH);
-        break;
-        
-      case 3: // Vermelho para carros, verde para pedestres
-        digitalWrite(ledRedCar, HIGH);
-        digitalWrite(ledGreenPedestrian, HIGH);
-        break;
-        
-      case 4: // Vermelho para carros, vermelho para pedestres (diferença de 5s)
-        digitalWrite(ledRedCar, HIGH);
-        digitalWrite(ledRedPedestrian, HIGH);
-        break;
-      default:
-        // Estado inválido - mantém todos os LEDs desligados
-        break;
-    }
-}
-
-void turnAllLEDSOff() {
-  digitalWrite(ledRedCar, LOW);
-  digitalWrite(ledYellowCar, LOW);
-  digitalWrite(ledGreenCar, LOW);
-  digitalWrite(ledGreenPedestrian, LOW);
-  digitalWrite(ledRedPedestrian, LOW);
+void sleepUntilNextInterrupt() {
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  sleep_enable();
+  sleep_cpu();
+  sleep_disable();
 }
 
 /**
@@ -12,6 +12,20 @@
 #define CONFIG_H
 
 #include <Arduino.h>
+#include "Types.h"
+
+/**
+ * @brief Static allocation mode
+ *
+ * When 1, every object of the system (controllers, context, tasks, stacks
+ * and mutex) is placed in .data/.bss and there is no heap use after the
+ * boot, so the memory use is fully visible at link time. Requires
+ * configSUPPORT_STATIC_ALLOCATION = 1 in FreeRTOSConfig.h, and allows
+ * configSUPPORT_DYNAMIC_ALLOCATION = 0 to win back the heap region.
+ */
+#ifndef SEMAPHORE_STATIC_ALLOCATION
+#define SEMAPHORE_STATIC_ALLOCATION 0
+#endif
 
 namespace SemaphoreSystem {
 
@@ -28,6 +42,30 @@ namespace HardwareConfig {
     constexpr uint8_t LED_GREEN_PEDESTRIAN = 10;
     constexpr uint8_t LED_RED_PEDESTRIAN = 9;
 }
+/**
+ * @brief Multi-intersection configurations
+ * Several signal heads driven from one board by a single scheduler task
+ */
+namespace IntersectionConfig {
+    // When disabled, only the HardwareConfig signal head is controlled
+    constexpr bool ENABLE_MULTI_INTERSECTION = false;
+
+    constexpr uint8_t INTERSECTION_COUNT = 2;
+
+    // Pins of each signal head: red car, yellow car, green car, red pedestrian, green pedestrian
+    constexpr PinMap INTERSECTION_PINS[INTERSECTION_COUNT] = {
+        PinMap(HardwareConfig::LED_RED_CAR, HardwareConfig::LED_YELLOW_CAR, HardwareConfig::LED_GREEN_CAR,
+               HardwareConfig::LED_RED_PEDESTRIAN, HardwareConfig::LED_GREEN_PEDESTRIAN),
+        PinMap(8, 7, 6, 4, 5)
+    };
+
+    // Phase offset of each intersection in the cycle ("green wave"), in milliseconds
+    constexpr uint32_t PHASE_OFFSETS_MS[INTERSECTION_COUNT] = {
+        0,
+        8000
+    };
+}
+
 /**
  * @brief Semaphore timing configurations
  * All timings are in milliseconds
@@ -48,18 +86,30 @@ namespace TimingConfig {
 
 /**
  * @brief FreeRTOS configurations
+ * Plain integer types, so this file does not need the FreeRTOS headers
  */
-namespace FreeRTOSConfig {
+namespace RTOSConfig {
     // Stack size for tasks
     constexpr uint16_t SEMAPHORE_TASK_STACK_SIZE = 256;
-    constexpr uint16_t MONITOR_TASK_STACK_SIZE = 128;
+    constexpr uint16_t MONITOR_TASK_STACK_SIZE = 192; // Hold a log line buffer
+    constexpr uint16_t LOG_DRAIN_TASK_STACK_SIZE = 128;
 
     // Task priorities
-    constexpr UBaseType_t SEMAPHORE_TASK_PRIORITY = 2;
-    constexpr UBaseType_t MONITOR_TASK_PRIORITY = 1;
+    constexpr uint8_t SEMAPHORE_TASK_PRIORITY = 2;
+    constexpr uint8_t MONITOR_TASK_PRIORITY = 1;
+    constexpr uint8_t LOG_DRAIN_TASK_PRIORITY = 0; // Run only when the others are blocked
 
     // Period of verification for task of monitoring
-    constexpr TickType_t MONITOR_PERIOD_MS = 1000;
+    constexpr uint32_t MONITOR_PERIOD_MS = 1000;
+
+    // Control task sleeps until the next state deadline (one wakeup per transition)
+    // When disabled, the task polls the state machine every CONTROL_POLL_PERIOD_MS
+    constexpr bool ENABLE_DEADLINE_SCHEDULING = true;
+    constexpr uint32_t CONTROL_POLL_PERIOD_MS = 10;
+
+    // Measure stack, CPU share, activations and mutex waits of each task
+    // (printed by the monitor in text mode, see Task_Profiler.h)
+    constexpr bool ENABLE_TASK_PROFILING = true;
 }
 
 /**
@@ -68,6 +118,24 @@ namespace FreeRTOSConfig {
 namespace SerialConfig {
     constexpr uint32_t BAUD_RATE = 115200;
     constexpr bool ENABLE_DEBUG = true;
+
+    // Messages below this level are discarded (DEBUG also requires ENABLE_DEBUG)
+    constexpr LogLevel LOG_LEVEL = LogLevel::DEBUG;
+
+    // Largest text status dump of the monitor, committed at once before the
+    // log drain (lowest priority) can run: ~360 bytes with the task profile
+    constexpr uint16_t TEXT_STATUS_MAX_SIZE = RTOSConfig::ENABLE_TASK_PROFILING ? 400 : 200;
+
+    // Log ring buffer size in bytes (power of two) and max size of one line
+    // (the ring holds LOG_BUFFER_SIZE - 1 bytes)
+    constexpr uint16_t LOG_BUFFER_SIZE = RTOSConfig::ENABLE_TASK_PROFILING ? 512 : 256;
+    constexpr uint8_t LOG_LINE_SIZE = 48;
+
+    static_assert(LOG_BUFFER_SIZE - 1 >= TEXT_STATUS_MAX_SIZE,
+                  "LOG_BUFFER_SIZE must hold a whole status dump of the monitor");
+
+    // Monitor output; with BINARY use LOG_LEVEL = WARN or higher to keep the line quiet
+    constexpr TelemetryFormat TELEMETRY_FORMAT = TelemetryFormat::TEXT;
 }
 
 } // namespace SemaphoreSystem
@@ -16,6 +16,135 @@
 
 namespace SemaphoreSystem {
 
+/**
+ * @brief Compile-time pin to PORT register mapping
+ * 
+ * Mirror of the core digitalPinToPort/digitalPinToBitMask tables, what
+ * live in PROGMEM and can't be used in constant expressions. With it a
+ * full LedConfiguration is written as one read-modify-write per PORT.
+ */
+namespace PortMapping {
+    enum class Port : uint8_t {
+        NONE, A, B, C, D, E, F, G, H, J, K, L
+    };
+
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
+    #define SEMAPHORE_DIRECT_PORT_IO 1
+
+    // Uno/Nano: D0-D7 = PD0-7, D8-D13 = PB0-5, A0-A5 (D14-D19) = PC0-5
+    constexpr Port portOf(uint8_t pin) {
+        return pin < 8  ? Port::D :
+               pin < 14 ? Port::B :
+               pin < 20 ? Port::C : Port::NONE;
+    }
+
+    constexpr uint8_t bitOf(uint8_t pin) {
+        return pin < 8  ? static_cast<uint8_t>(1 << pin) :
+               pin < 14 ? static_cast<uint8_t>(1 << (pin - 8)) :
+               pin < 20 ? static_cast<uint8_t>(1 << (pin - 14)) : 0;
+    }
+#elif defined(__AVR_ATmega2560__) || defined(__AVR_ATmega1280__)
+    #define SEMAPHORE_DIRECT_PORT_IO 1
+
+    // Mega: irregular mapping, see variants/mega/pins_arduino.h
+    constexpr Port portOf(uint8_t pin) {
+        return (pin <= 1 || pin == 2 || pin == 3 || pin == 5) ? Port::E :
+               pin == 4                   ? Port::G :
+               (pin >= 6 && pin <= 9)     ? Port::H :
+               (pin >= 10 && pin <= 13)   ? Port::B :
+               (pin == 14 || pin == 15)   ? Port::J :
+               (pin == 16 || pin == 17)   ? Port::H :
+               (pin >= 18 && pin <= 21)   ? Port::D :
+               (pin >= 22 && pin <= 29)   ? Port::A :
+               (pin >= 30 && pin <= 37)   ? Port::C :
+               pin == 38                  ? Port::D :
+               (pin >= 39 && pin <= 41)   ? Port::G :
+               (pin >= 42 && pin <= 49)   ? Port::L :
+               (pin >= 50 && pin <= 53)   ? Port::B :
+               (pin >= 54 && pin <= 61)   ? Port::F :
+               (pin >= 62 && pin <= 69)   ? Port::K : Port::NONE;
+    }
+
+    constexpr uint8_t bitIndexOf(uint8_t pin) {
+        return pin <= 1                   ? pin :
+               (pin == 2 || pin == 3)     ? pin + 2 :
+               pin == 4                   ? 5 :
+               pin == 5                   ? 3 :
+               (pin >= 6 && pin <= 9)     ? pin - 3 :
+               (pin >= 10 && pin <= 13)   ? pin - 6 :
+               (pin == 14 || pin == 15)   ? 15 - pin :
+               (pin == 16 || pin == 17)   ? 17 - pin :
+               (pin >= 18 && pin <= 21)   ? 21 - pin :
+               (pin >= 22 && pin <= 29)   ? pin - 22 :
+               (pin >= 30 && pin <= 37)   ? 37 - pin :
+               pin == 38                  ? 7 :
+               (pin >= 39 && pin <= 41)   ? 41 - pin :
+               (pin >= 42 && pin <= 49)   ? 49 - pin :
+               (pin >= 50 && pin <= 53)   ? 53 - pin :
+               (pin >= 54 && pin <= 61)   ? pin - 54 :
+               (pin >= 62 && pin <= 69)   ? pin - 62 : 0;
+    }
+
+    constexpr uint8_t bitOf(uint8_t pin) {
+        return portOf(pin) == Port::NONE ? 0 : static_cast<uint8_t>(1 << bitIndexOf(pin));
+    }
+#else
+    #define SEMAPHORE_DIRECT_PORT_IO 0
+#endif
+
+#if SEMAPHORE_DIRECT_PORT_IO
+    /**
+     * @brief Bit mask of the LEDs of a PORT register
+     */
+    constexpr uint8_t ledMaskOf(Port port) {
+        using namespace HardwareConfig;
+        return (portOf(LED_RED_CAR) == port ? bitOf(LED_RED_CAR) : 0) |
+               (portOf(LED_YELLOW_CAR) == port ? bitOf(LED_YELLOW_CAR) : 0) |
+               (portOf(LED_GREEN_CAR) == port ? bitOf(LED_GREEN_CAR) : 0) |
+               (portOf(LED_RED_PEDESTRIAN) == port ? bitOf(LED_RED_PEDESTRIAN) : 0) |
+               (portOf(LED_GREEN_PEDESTRIAN) == port ? bitOf(LED_GREEN_PEDESTRIAN) : 0);
+    }
+
+    /**
+     * @brief Output value of the LEDs of a PORT register to a configuration
+     * The pin comparisons are resolved at compile time
+     */
+    inline uint8_t ledValueOf(Port port, const LedConfiguration& config) {
+        using namespace HardwareConfig;
+        uint8_t value = 0;
+
+        if (portOf(LED_RED_CAR) == port && config.isOn(LedId::RED_CAR)) {
+            value |= bitOf(LED_RED_CAR);
+        }
+        if (portOf(LED_YELLOW_CAR) == port && config.isOn(LedId::YELLOW_CAR)) {
+            value |= bitOf(LED_YELLOW_CAR);
+        }
+        if (portOf(LED_GREEN_CAR) == port && config.isOn(LedId::GREEN_CAR)) {
+            value |= bitOf(LED_GREEN_CAR);
+        }
+        if (portOf(LED_RED_PEDESTRIAN) == port && config.isOn(LedId::RED_PEDESTRIAN)) {
+            value |= bitOf(LED_RED_PEDESTRIAN);
+        }
+        if (portOf(LED_GREEN_PEDESTRIAN) == port && config.isOn(LedId::GREEN_PEDESTRIAN)) {
+            value |= bitOf(LED_GREEN_PEDESTRIAN);
+        }
+
+        return value;
+    }
+
+    /**
+     * @brief Read-modify-write of the LED bits of one PORT register
+     * Ports without LEDs are removed by the compiler (mask == 0)
+     */
+    inline void writePort(volatile uint8_t& portRegister, Port port, const LedConfiguration& config) {
+        const uint8_t mask = ledMaskOf(port);
+        if (mask != 0) {
+            portRegister = (portRegister & ~mask) | ledValueOf(port, config);
+        }
+    }
+#endif
+}
+
 /**
  * @brief Interface to control the hardware components
  * Allow create mocks for unit testing
@@ -55,13 +184,34 @@ private:
         pinMode(pin, OUTPUT);
         digitalWrite(pin, LOW); // Safety initial state
     }
+
+#if !SEMAPHORE_DIRECT_PORT_IO
+    /**
+     * @brief Write only the LEDs of the configuration with a given status
+     */
+    void writeLedsWithStatus(const LedConfiguration& config, LedStatus status) {
+        using namespace HardwareConfig;
+
+        if (config.getStatus(LedId::RED_CAR) == status) setLedState(LED_RED_CAR, status);
+        if (config.getStatus(LedId::YELLOW_CAR) == status) setLedState(LED_YELLOW_CAR, status);
+        if (config.getStatus(LedId::GREEN_CAR) == status) setLedState(LED_GREEN_CAR, status);
+        if (config.getStatus(LedId::RED_PEDESTRIAN) == status) setLedState(LED_RED_PEDESTRIAN, status);
+        if (config.getStatus(LedId::GREEN_PEDESTRIAN) == status) setLedState(LED_GREEN_PEDESTRIAN, status);
+    }
+#endif
 public:
     /**
      * @brief Get the singleton instance (Singleton)
      */
     static ArduinoHardwareController& getInstance() {
         if (instance_ == nullptr) {
+#if SEMAPHORE_STATIC_ALLOCATION
+            // Statically placed, constructed at the first call
+            static ArduinoHardwareController instance;
+            instance_ = &instance;
+#else
             instance_ = new ArduinoHardwareController();
+#endif
         }
         return *instance_;
     }
@@ -99,20 +249,40 @@ public:
      * @brief Apply a full LED configuration
      * @param config The LedConfiguration to apply
      * 
-     * Use atomic-like operation to minimize intermediates states
+     * With direct port IO the whole configuration is written as one
+     * read-modify-write per PORT register with interrupts disabled,
+     * so there is no intermediate (dark or mixed) state.
      */
     void applyConfiguration(const LedConfiguration& config) override {
-        using namespace HardwareConfig;
+#if SEMAPHORE_DIRECT_PORT_IO
+        using namespace PortMapping;
 
-        // Firstly turn off all LEDs to avoid glitches
-        turnAllLedsOff();
+        const uint8_t oldSREG = SREG;
+        cli();
+
+    #if defined(__AVR_ATmega2560__) || defined(__AVR_ATmega1280__)
+        writePort(PORTA, Port::A, config);
+        writePort(PORTE, Port::E, config);
+        writePort(PORTF, Port::F, config);
+        writePort(PORTG, Port::G, config);
+        writePort(PORTH, Port::H, config);
+        writePort(PORTJ, Port::J, config);
+        writePort(PORTK, Port::K, config);
+        writePort(PORTL, Port::L, config);
+    #endif
+        writePort(PORTB, Port::B, config);
+        writePort(PORTC, Port::C, config);
+        writePort(PORTD, Port::D, config);
+
+        SREG = oldSREG;
+#else
+        using namespace HardwareConfig;
 
-        // Apply the new configuration
-        setLedState(LED_RED_CAR, config.redCar);
-        setLedState(LED_YELLOW_CAR, config.yellowCar);
-        setLedState(LED_GREEN_CAR, config.greenCar);
-        setLedState(LED_RED_PEDESTRIAN, config.redPedestrian);
-        setLedState(LED_GREEN_PEDESTRIAN, config.greenPedestrian);
+        // Firstly turn off the LEDs what go OFF, then turn on the new ones.
+        // Avoid the dark window of turning off all LEDs and overlaps
+        writeLedsWithStatus(config, LedStatus::OFF);
+        writeLedsWithStatus(config, LedStatus::ON);
+#endif
     }
 
     /**
@@ -120,6 +290,9 @@ public:
      * Ensure a known safe state
      */
     void turnAllLedsOff() override {
+#if SEMAPHORE_DIRECT_PORT_IO
+        applyConfiguration(LedConfiguration());
+#else
         using namespace HardwareConfig;
 
         digitalWrite(LED_RED_CAR, LOW);
@@ -127,6 +300,7 @@ public:
         digitalWrite(LED_GREEN_CAR, LOW);
         digitalWrite(LED_RED_PEDESTRIAN, LOW);
         digitalWrite(LED_GREEN_PEDESTRIAN, LOW);
+#endif
     }
 
     /**
@@ -138,6 +312,158 @@ public:
 // Initialize static pointer
 ArduinoHardwareController* ArduinoHardwareController::instance_ = nullptr;
 
+/**
+ * @brief Hardware control to a signal head with runtime pin mapping
+ *
+ * Used when several intersections are driven from one board. The PORT
+ * registers and bit masks are resolved once in initialize(), so each
+ * configuration is still one read-modify-write per PORT register.
+ */
+class PinMappedHardwareController : public IHardwareController {
+private:
+    static constexpr uint8_t LED_COUNT = static_cast<uint8_t>(LedId::TOTAL_LEDS);
+
+    PinMap pins_;
+
+#if SEMAPHORE_DIRECT_PORT_IO
+    /**
+     * @brief LEDs sharing the same PORT register
+     */
+    struct OutputGroup {
+        volatile uint8_t* outputRegister;
+        uint8_t mask;
+    };
+
+    OutputGroup groups_[LED_COUNT];
+    uint8_t groupCount_;
+    uint8_t ledGroup_[LED_COUNT]; // Group index of each LedId
+    uint8_t ledBit_[LED_COUNT];   // Bit mask of each LedId
+
+    /**
+     * @brief Resolve the PORT register and bit of each LED
+     */
+    void resolveOutputGroups() {
+        groupCount_ = 0;
+
+        for (uint8_t led = 0; led < LED_COUNT; led++) {
+            const uint8_t pin = pins_.pinOf(static_cast<LedId>(led));
+            volatile uint8_t* outputRegister = portOutputRegister(digitalPinToPort(pin));
+
+            // Find (or create) the group of this register
+            uint8_t group = 0;
+            while (group < groupCount_ && groups_[group].outputRegister != outputRegister) {
+                group++;
+            }
+            if (group == groupCount_) {
+                groups_[groupCount_++] = OutputGroup{outputRegister, 0};
+            }
+
+            ledBit_[led] = digitalPinToBitMask(pin);
+            ledGroup_[led] = group;
+            groups_[group].mask |= ledBit_[led];
+        }
+    }
+#endif
+
+public:
+    /**
+     * @brief Constructor
+     * @param pins The pins of the signal head
+     */
+    explicit PinMappedHardwareController(const PinMap& pins =
+        PinMap(HardwareConfig::LED_RED_CAR, HardwareConfig::LED_YELLOW_CAR, HardwareConfig::LED_GREEN_CAR,
+               HardwareConfig::LED_RED_PEDESTRIAN, HardwareConfig::LED_GREEN_PEDESTRIAN))
+        : pins_(pins)
+#if SEMAPHORE_DIRECT_PORT_IO
+        , groupCount_(0)
+#endif
+    {}
+
+    // Delete copy constructor and assignment operator
+    PinMappedHardwareController(const PinMappedHardwareController&) = delete;
+    PinMappedHardwareController& operator=(const PinMappedHardwareController&) = delete;
+
+    /**
+     * @brief Change the pins (must be called before initialize)
+     */
+    void setPinMap(const PinMap& pins) {
+        pins_ = pins;
+    }
+
+    /**
+     * @brief Initialize the hardware (pins configuration)
+     * Set all pins as OUTPUT and initial state OFF
+     */
+    void initialize() override {
+        for (uint8_t led = 0; led < LED_COUNT; led++) {
+            const uint8_t pin = pins_.pinOf(static_cast<LedId>(led));
+            pinMode(pin, OUTPUT);
+            digitalWrite(pin, LOW); // Safety initial state
+        }
+
+#if SEMAPHORE_DIRECT_PORT_IO
+        resolveOutputGroups();
+#endif
+    }
+
+    /**
+     * @brief Set the state of a specific LED
+     */
+    void setLedState(uint8_t pin, LedStatus status) override {
+        digitalWrite(pin, toDigitalValue(status));
+    }
+
+    /**
+     * @brief Apply a full LED configuration
+     * One read-modify-write per PORT register with interrupts disabled
+     */
+    void applyConfiguration(const LedConfiguration& config) override {
+#if SEMAPHORE_DIRECT_PORT_IO
+        uint8_t values[LED_COUNT] = {0};
+
+        for (uint8_t led = 0; led < LED_COUNT; led++) {
+            if (config.isOn(static_cast<LedId>(led))) {
+                values[ledGroup_[led]] |= ledBit_[led];
+            }
+        }
+
+        const uint8_t oldSREG = SREG;
+        cli();
+
+        for (uint8_t group = 0; group < groupCount_; group++) {
+            volatile uint8_t& outputRegister = *groups_[group].outputRegister;
+            outputRegister = (outputRegister & ~groups_[group].mask) | values[group];
+        }
+
+        SREG = oldSREG;
+#else
+        // Firstly turn off the LEDs what go OFF, then turn on the new ones
+        for (uint8_t led = 0; led < LED_COUNT; led++) {
+            if (!config.isOn(static_cast<LedId>(led))) {
+                setLedState(pins_.pinOf(static_cast<LedId>(led)), LedStatus::OFF);
+            }
+        }
+        for (uint8_t led = 0; led < LED_COUNT; led++) {
+            if (config.isOn(static_cast<LedId>(led))) {
+                setLedState(pins_.pinOf(static_cast<LedId>(led)), LedStatus::ON);
+            }
+        }
+#endif
+    }
+
+    /**
+     * @brief Turn off all LEDs
+     */
+    void turnAllLedsOff() override {
+        applyConfiguration(LedConfiguration());
+    }
+
+    /**
+     * @brief Destructor
+     */
+    ~PinMappedHardwareController() override = default;
+};
+
 } // namespace SemaphoreSystem
 
 #endif // HARDWARE_ABSTRACTION_LAYER_H
\ No newline at end of file
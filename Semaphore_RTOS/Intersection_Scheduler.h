@@ -0,0 +1,288 @@
+/**
+ * @file Intersection_Scheduler.h
+ * @brief Scheduler of several intersections under one FreeRTOS task
+ * @version 2.0.0
+ *
+ * Own an array of state machines (one per signal head) and serve all of
+ * them from a single task, using a min-heap of the next transition
+ * deadlines. Each transition costs O(log N), instead of one task and one
+ * stack per intersection.
+ */
+
+#ifndef INTERSECTION_SCHEDULER_H
+#define INTERSECTION_SCHEDULER_H
+
+#include <Arduino.h>
+#include <Arduino_FreeRTOS.h>
+#include "Config.h"
+#include "Types.h"
+#include "Hardware_Abstraction_Layer.h"
+#include "Semaphore_State_Machine.h"
+#include "SemaphoreTasks.h"
+
+namespace SemaphoreSystem {
+
+/**
+ * @brief One signal head: its hardware and its state machine
+ */
+struct Intersection {
+    PinMappedHardwareController hardware;
+    SemaphoreStateMachine stateMachine;
+    uint32_t phaseOffset;
+
+    Intersection()
+        : hardware(),
+          stateMachine(hardware),
+          phaseOffset(0) {}
+
+    // Delete copy (the state machine references the hardware member)
+    Intersection(const Intersection&) = delete;
+    Intersection& operator=(const Intersection&) = delete;
+};
+
+/**
+ * @brief Scheduler of N intersections with phase offset coordination
+ *
+ * @tparam N Number of intersections
+ */
+template <uint8_t N>
+class IntersectionScheduler {
+private:
+    static_assert(N > 0, "IntersectionScheduler needs at least one intersection");
+
+    Intersection intersections_[N];
+    uint32_t deadlines_[N]; // Cached next transition time of each intersection
+    uint8_t heap_[N];       // Min-heap of intersection indexes ordered by deadline
+    SharedContext* context_;
+    bool started_;
+
+    /**
+     * @brief Compare deadlines safely across the millis() overflow
+     */
+    static bool isBefore(uint32_t a, uint32_t b) {
+        return static_cast<int32_t>(a - b) < 0;
+    }
+
+    bool heapLess(uint8_t i, uint8_t j) const {
+        return isBefore(deadlines_[heap_[i]], deadlines_[heap_[j]]);
+    }
+
+    void heapSwap(uint8_t i, uint8_t j) {
+        const uint8_t tmp = heap_[i];
+        heap_[i] = heap_[j];
+        heap_[j] = tmp;
+    }
+
+    /**
+     * @brief Restore the heap after the key of a node increased
+     */
+    void siftDown(uint8_t i) {
+        for (;;) {
+            const uint8_t left = 2 * i + 1;
+            const uint8_t right = left + 1;
+            uint8_t smallest = i;
+
+            if (left < N && heapLess(left, smallest)) smallest = left;
+            if (right < N && heapLess(right, smallest)) smallest = right;
+            if (smallest == i) return;
+
+            heapSwap(i, smallest);
+            i = smallest;
+        }
+    }
+
+    /**
+     * @brief Build the heap from all the deadlines (O(N))
+     */
+    void buildHeap() {
+        for (uint8_t i = 0; i < N; i++) {
+            heap_[i] = i;
+            deadlines_[i] = intersections_[i].stateMachine.getStateDeadline();
+        }
+        for (int16_t i = N / 2 - 1; i >= 0; i--) {
+            siftDown(static_cast<uint8_t>(i));
+        }
+    }
+
+public:
+    /**
+     * @brief Constructor
+     */
+    IntersectionScheduler()
+        : context_(nullptr),
+          started_(false) {}
+
+    // Delete copy constructor and assignment operator
+    IntersectionScheduler(const IntersectionScheduler&) = delete;
+    IntersectionScheduler& operator=(const IntersectionScheduler&) = delete;
+
+    /**
+     * @brief Configure one intersection (must be called before begin)
+     * @param index Intersection index
+     * @param pins Pins of its signal head
+     * @param phaseOffsetMs Offset of its cycle relative to the others
+     */
+    bool configure(uint8_t index, const PinMap& pins, uint32_t phaseOffsetMs) {
+        if (index >= N || started_) {
+            return false;
+        }
+
+        intersections_[index].hardware.setPinMap(pins);
+        intersections_[index].phaseOffset = phaseOffsetMs;
+        return true;
+    }
+
+    /**
+     * @brief Bind the shared context used by the task (lock and statistics)
+     */
+    void bindContext(SharedContext& context) {
+        context_ = &context;
+    }
+
+    SharedContext* getContext() const {
+        return context_;
+    }
+
+    /**
+     * @brief Initialize and start all the intersections
+     */
+    void begin() {
+        for (uint8_t i = 0; i < N; i++) {
+            intersections_[i].stateMachine.initialize();
+            intersections_[i].stateMachine.begin(intersections_[i].phaseOffset);
+        }
+
+        buildHeap();
+        started_ = true;
+    }
+
+    /**
+     * @brief Execute all the transitions what are due
+     * @return Number of transitions executed
+     */
+    uint8_t serviceDueIntersections() {
+        if (!started_) {
+            return 0;
+        }
+
+        const uint32_t currentTime = millis();
+        uint8_t transitions = 0;
+
+        // Each intersection transitions at most once per call
+        for (uint8_t n = 0; n < N; n++) {
+            const uint8_t index = heap_[0];
+
+            if (isBefore(currentTime, deadlines_[index])) {
+                break;
+            }
+
+            if (intersections_[index].stateMachine.update()) {
+                transitions++;
+            }
+
+            deadlines_[index] = intersections_[index].stateMachine.getStateDeadline();
+            siftDown(0);
+        }
+
+        return transitions;
+    }
+
+    /**
+     * @brief Get the time until the earliest transition (in milliseconds)
+     */
+    uint32_t getTimeUntilNextTransition() const {
+        if (!started_) {
+            return 0;
+        }
+
+        const uint32_t deadline = deadlines_[heap_[0]];
+        const uint32_t currentTime = millis();
+        return isBefore(currentTime, deadline) ? deadline - currentTime : 0;
+    }
+
+    /**
+     * @brief Get the state machine of one intersection
+     */
+    SemaphoreStateMachine& getStateMachine(uint8_t index) {
+        return intersections_[index].stateMachine;
+    }
+
+    /**
+     * @brief Get the hardware of one intersection
+     */
+    IHardwareController& getHardware(uint8_t index) {
+        return intersections_[index].hardware;
+    }
+
+    /**
+     * @brief Emergency mode - turn off all the intersections
+     */
+    void emergencyStop() {
+        for (uint8_t i = 0; i < N; i++) {
+            intersections_[i].stateMachine.emergencyStop();
+        }
+    }
+
+    static constexpr uint8_t size() {
+        return N;
+    }
+};
+
+/**
+ * @brief Control task of the intersection scheduler
+ *
+ * Replace semaphoreControlTask when several intersections are used.
+ * Sleep until the earliest deadline of all the intersections.
+ *
+ * @param pvParameters Pointer to IntersectionScheduler<N>
+ */
+template <uint8_t N>
+void intersectionSchedulerTask(void* pvParameters) {
+    IntersectionScheduler<N>* scheduler = static_cast<IntersectionScheduler<N>*>(pvParameters);
+
+    if (scheduler == nullptr || scheduler -> getContext() == nullptr) {
+        logMessage(LogLevel::ERROR, F("[ERROR] Scheduler task: null scheduler or context!"));
+        vTaskDelete(nullptr);
+        return;
+    }
+
+    SharedContext& context = *scheduler -> getContext();
+
+    {
+        LogRecord record(LogLevel::INFO);
+        record.print(F("[TASK] Intersection Scheduler Task started ("));
+        record.print(N);
+        record.println(F(" intersections)"));
+    }
+
+    // Infinite loop of task
+    for (;;) {
+        // Inactive system sleeps until notified
+        TickType_t sleepTicks = portMAX_DELAY;
+
+        {
+            ScopedLock lock(context);
+            ProfiledSection profile(ProfiledTask::CONTROL);
+
+            if (lock.isLocked() && context.isSystemActive()) {
+                const uint8_t transitions = scheduler -> serviceDueIntersections();
+
+                if (transitions > 0) {
+                    context.incrementTransitions(transitions);
+                    context.publishSnapshot(uxTaskGetStackHighWaterMark(nullptr));
+                }
+
+                // Rounded up to the tick; a wakeup early by the elapsed part of the
+                // current tick only costs one more pass (no transition, sleep again)
+                sleepTicks = msToTicksCeil(scheduler -> getTimeUntilNextTransition());
+            }
+        } // Lock is released automatically here (RAII)
+
+        // Block until the earliest deadline or an early notification
+        ulTaskNotifyTake(pdTRUE, sleepTicks);
+    }
+}
+
+} // namespace SemaphoreSystem
+
+#endif // INTERSECTION_SCHEDULER_H
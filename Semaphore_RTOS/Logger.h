@@ -0,0 +1,303 @@
+/**
+ * @file Logger.h
+ * @brief Non-blocking logging subsystem with a ring buffer
+ * @version 2.0.0
+ *
+ * Tasks write log lines into a fixed-size ring buffer in O(1) without
+ * waiting on the UART. A low-priority drain (see logDrainTask) flushes
+ * the buffer only as fast as the HardwareSerial TX buffer accepts.
+ * Before a drain is attached (boot), the lines are written directly.
+ */
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <Arduino.h>
+#include "Types.h"
+#include "Config.h"
+
+namespace SemaphoreSystem {
+
+/**
+ * @brief Ring buffer and global state of the logger
+ *
+ * Only static members: one logger for the whole system. The critical
+ * sections only disable the interrupts, so it works with and without
+ * FreeRTOS. Task context only: each commit wakes the drain with
+ * xTaskNotifyGive (or writes to the UART before the drain is attached),
+ * neither of which may be called from an ISR.
+ */
+class Logger {
+public:
+    using DrainWakeFunction = void (*)();
+
+    static constexpr uint16_t BUFFER_SIZE = SerialConfig::LOG_BUFFER_SIZE;
+    static constexpr uint16_t BUFFER_MASK = BUFFER_SIZE - 1;
+
+    static_assert((BUFFER_SIZE & BUFFER_MASK) == 0, "LOG_BUFFER_SIZE must be a power of two");
+
+private:
+    static uint8_t buffer_[BUFFER_SIZE];
+    static volatile uint16_t head_; // Next write position
+    static volatile uint16_t tail_; // Next read position
+
+    static Print* output_;
+    static DrainWakeFunction wakeDrain_;
+    static LogLevel level_;
+
+    static volatile uint16_t droppedLines_;
+    static volatile uint32_t droppedBytes_;
+
+    static uint16_t usedSpace() {
+        return (head_ - tail_) & BUFFER_MASK;
+    }
+
+public:
+    /**
+     * @brief Define the output and the minimum level
+     */
+    static void begin(Print& output, LogLevel level = SerialConfig::LOG_LEVEL) {
+        output_ = &output;
+        level_ = level;
+    }
+
+    /**
+     * @brief Change the minimum level at runtime
+     */
+    static void setLevel(LogLevel level) {
+        level_ = level;
+    }
+
+    /**
+     * @brief Verify if a message of this level will be logged
+     */
+    static bool isEnabled(LogLevel level) {
+        if (level == LogLevel::DEBUG && !SerialConfig::ENABLE_DEBUG) {
+            return false;
+        }
+        return level != LogLevel::NONE && level >= level_ && output_ != nullptr;
+    }
+
+    /**
+     * @brief Attach the drain: from now on the lines are buffered
+     * @param wake Function called after each commit to wake the drain
+     * (from the task that logged, never from an ISR)
+     */
+    static void attachDrain(DrainWakeFunction wake) {
+        wakeDrain_ = wake;
+    }
+
+    /**
+     * @brief Commit a complete line (or frame) to the ring buffer
+     *
+     * The whole line is copied or dropped (never split), with a bounded
+     * critical section of at most LOG_LINE_SIZE bytes.
+     *
+     * @return false if the line was dropped (buffer full)
+     */
+    static bool commit(const uint8_t* data, uint16_t length) {
+        if (output_ == nullptr || length == 0) {
+            return false;
+        }
+
+        // Without drain (boot, bare sketches) write directly
+        if (wakeDrain_ == nullptr) {
+            output_->write(data, length);
+            return true;
+        }
+
+        const uint8_t oldSREG = SREG;
+        cli();
+
+        if (length > BUFFER_MASK - usedSpace()) {
+            droppedLines_ = droppedLines_ + 1;
+            droppedBytes_ = droppedBytes_ + length;
+            SREG = oldSREG;
+            return false;
+        }
+
+        uint16_t head = head_;
+        for (uint16_t i = 0; i < length; i++) {
+            buffer_[head] = data[i];
+            head = (head + 1) & BUFFER_MASK;
+        }
+        head_ = head;
+
+        SREG = oldSREG;
+
+        wakeDrain_();
+        return true;
+    }
+
+    /**
+     * @brief Flush the buffer only as much as the output accepts
+     * Must be called only by the drain (single reader)
+     *
+     * @return Number of bytes written
+     */
+    static uint16_t drain() {
+        if (output_ == nullptr) {
+            return 0;
+        }
+
+        uint16_t written = 0;
+
+        for (;;) {
+            const uint8_t oldSREG = SREG;
+            cli();
+            const uint16_t head = head_;
+            SREG = oldSREG;
+
+            const uint16_t tail = tail_;
+            if (head == tail) {
+                break;
+            }
+
+            // Contiguous bytes until the end of the buffer
+            uint16_t chunk = (head > tail) ? head - tail : BUFFER_SIZE - tail;
+            const int space = output_->availableForWrite();
+            if (space <= 0) {
+                break;
+            }
+            if (chunk > static_cast<uint16_t>(space)) {
+                chunk = static_cast<uint16_t>(space);
+            }
+
+            output_->write(&buffer_[tail], chunk);
+            written += chunk;
+
+            cli();
+            tail_ = (tail + chunk) & BUFFER_MASK;
+            SREG = oldSREG;
+        }
+
+        return written;
+    }
+
+    /**
+     * @brief Write all the buffered bytes, blocking (fatal error paths)
+     */
+    static void flushBlocking() {
+        if (output_ == nullptr) {
+            return;
+        }
+
+        while (!isEmpty()) {
+            const uint16_t tail = tail_;
+            output_->write(buffer_[tail]);
+
+            const uint8_t oldSREG = SREG;
+            cli();
+            tail_ = (tail + 1) & BUFFER_MASK;
+            SREG = oldSREG;
+        }
+    }
+
+    static bool isEmpty() {
+        const uint8_t oldSREG = SREG;
+        cli();
+        const bool empty = head_ == tail_;
+        SREG = oldSREG;
+        return empty;
+    }
+
+    /**
+     * @brief Overflow counters (lines dropped because the buffer was full)
+     */
+    static uint16_t getDroppedLines() {
+        const uint8_t oldSREG = SREG;
+        cli();
+        const uint16_t dropped = droppedLines_;
+        SREG = oldSREG;
+        return dropped;
+    }
+
+    static uint32_t getDroppedBytes() {
+        const uint8_t oldSREG = SREG;
+        cli();
+        const uint32_t dropped = droppedBytes_;
+        SREG = oldSREG;
+        return dropped;
+    }
+};
+
+// Static members definition
+uint8_t Logger::buffer_[Logger::BUFFER_SIZE];
+volatile uint16_t Logger::head_ = 0;
+volatile uint16_t Logger::tail_ = 0;
+Print* Logger::output_ = nullptr;
+Logger::DrainWakeFunction Logger::wakeDrain_ = nullptr;
+LogLevel Logger::level_ = SerialConfig::LOG_LEVEL;
+volatile uint16_t Logger::droppedLines_ = 0;
+volatile uint32_t Logger::droppedBytes_ = 0;
+
+/**
+ * @brief Log record with the Print interface (print/println)
+ *
+ * Format the text into a small line buffer on the stack and commit it to
+ * the Logger at each '\n' (and at the destruction). Lines longer than
+ * LOG_LINE_SIZE are committed in pieces. Disabled levels cost nothing
+ * besides the formatting calls.
+ */
+class LogRecord : public Print {
+private:
+    uint8_t line_[SerialConfig::LOG_LINE_SIZE];
+    uint8_t length_;
+    bool enabled_;
+
+    void commitLine() {
+        if (length_ > 0) {
+            Logger::commit(line_, length_);
+            length_ = 0;
+        }
+    }
+
+public:
+    explicit LogRecord(LogLevel level)
+        : length_(0),
+          enabled_(Logger::isEnabled(level)) {}
+
+    ~LogRecord() {
+        if (enabled_) {
+            commitLine();
+        }
+    }
+
+    // Delete copy constructor and assignment operator
+    LogRecord(const LogRecord&) = delete;
+    LogRecord& operator=(const LogRecord&) = delete;
+
+    /**
+     * @brief Verify if the record will be logged (skip expensive formatting)
+     */
+    explicit operator bool() const {
+        return enabled_;
+    }
+
+    size_t write(uint8_t c) override {
+        if (!enabled_) {
+            return 1;
+        }
+
+        line_[length_++] = c;
+
+        if (c == '\n' || length_ == sizeof(line_)) {
+            commitLine();
+        }
+        return 1;
+    }
+
+    using Print::write;
+};
+
+/**
+ * @brief Log a single line of text
+ */
+inline void logMessage(LogLevel level, const __FlashStringHelper* text) {
+    LogRecord record(level);
+    record.println(text);
+}
+
+} // namespace SemaphoreSystem
+
+#endif // LOGGER_H
@@ -16,9 +16,28 @@
 #include "Config.h"
 #include "Types.h"
 #include "Semaphore_State_Machine.h"
+#include "Status_Snapshot.h"
+#include "Logger.h"
+#include "Telemetry_Protocol.h"
+#include "Task_Profiler.h"
+
+#if SEMAPHORE_STATIC_ALLOCATION && (configSUPPORT_STATIC_ALLOCATION != 1)
+#error "SEMAPHORE_STATIC_ALLOCATION requires configSUPPORT_STATIC_ALLOCATION = 1 in FreeRTOSConfig.h"
+#endif
 
 namespace SemaphoreSystem {
 
+/**
+ * @brief Free bytes of the FreeRTOS heap (0 without dynamic allocation)
+ */
+inline size_t getFreeHeapSize() {
+#if configSUPPORT_DYNAMIC_ALLOCATION
+    return xPortGetFreeHeapSize();
+#else
+    return 0;
+#endif
+}
+
 /**
  * @brief Class what encapsulate the shared context between tasks
  * 
@@ -30,6 +49,10 @@ private:
     SemaphoreHandle_t mutex_;
     bool systemActive_;
     uint32_t totalTransitions_;
+    SnapshotChannel snapshotChannel_;
+#if SEMAPHORE_STATIC_ALLOCATION
+    StaticSemaphore_t mutexBuffer_;
+#endif
 
 public:
     /**
@@ -41,11 +64,18 @@ public:
           systemActive_(true),
           totalTransitions_(0) {
         // Create binary mutex to protection
+#if SEMAPHORE_STATIC_ALLOCATION
+        mutex_ = xSemaphoreCreateMutexStatic(&mutexBuffer_);
+#else
         mutex_ = xSemaphoreCreateMutex();
+#endif
         
         if (mutex_ == nullptr) {
-            Serial.println(F("[ERROR] Failed to create mutex!"))
+            logMessage(LogLevel::ERROR, F("[ERROR] Failed to create mutex!"));
         }
+
+        // Readers have a valid status before the first transition
+        publishSnapshot();
     }
 
     /**
@@ -60,7 +90,15 @@ public:
      */
     bool lock(TickType_t timeout = portMAX_DELAY) {
         if (mutex_ != nullptr) {
-            return xSemaphoreTake(mutex_, timeout) == pdTRUE;
+            if (!RTOSConfig::ENABLE_TASK_PROFILING) {
+                return xSemaphoreTake(mutex_, timeout) == pdTRUE;
+            }
+
+            const uint32_t waitStart = micros();
+            const bool locked = xSemaphoreTake(mutex_, timeout) == pdTRUE;
+
+            TaskProfiler::recordLockWait(micros() - waitStart);
+            return locked;
         }
         return false;
     }
@@ -91,8 +129,8 @@ public:
     /**
      * @brief Increment the transitions contator
      */
-    void incrementTransitions() {
-        totalTransitions_++;
+    void incrementTransitions(uint32_t count = 1) {
+        totalTransitions_ += count;
     }
 
     /**
@@ -102,6 +140,30 @@ public:
         return totalTransitions_;
     }
 
+    /**
+     * @brief Publish the current status to the lock-free readers
+     * Must be called by the control task, holding the lock
+     * @param controlStackWatermark Stack high-water mark of the caller task
+     */
+    void publishSnapshot(UBaseType_t controlStackWatermark = 0) {
+        StatusSnapshot snapshot;
+        snapshot.controlStackWatermark = controlStackWatermark;
+        snapshot.state = stateMachine_.getCurrentState();
+        snapshot.stateDeadline = stateMachine_.getStateDeadline();
+        snapshot.cycleCount = stateMachine_.getCycleCount();
+        snapshot.totalTransitions = totalTransitions_;
+
+        snapshotChannel_.publish(snapshot);
+    }
+
+    /**
+     * @brief Read the last published status without locking the mutex
+     * @return true if a consistent snapshot was read
+     */
+    bool readSnapshot(StatusSnapshot& snapshot) const {
+        return snapshotChannel_.read(snapshot);
+    }
+
     /**
      * @brief Destructor
      */
@@ -142,46 +204,141 @@ public:
     ScopedLock& operator=(const ScopedLock&) = delete;
 };
 
+/**
+ * @brief Convert milliseconds to ticks rounding up
+ * pdMS_TO_TICKS rounds down, what would wake the task before the deadline
+ */
+inline TickType_t msToTicksCeil(uint32_t ms) {
+    return static_cast<TickType_t>((ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS);
+}
+
+/**
+ * @brief Sleep of the control task in polling mode (at least one tick)
+ * A zero timeout would return at once and starve the lower priority tasks
+ */
+inline TickType_t pollPeriodTicks() {
+    return pdMS_TO_TICKS(RTOSConfig::CONTROL_POLL_PERIOD_MS) > 0
+               ? pdMS_TO_TICKS(RTOSConfig::CONTROL_POLL_PERIOD_MS)
+               : 1;
+}
+
 /**
  * @brief Principal task of semaphore
  * 
  * Responsable to update the states machine and manage
  * the transitions of semaphore
  * 
+ * In deadline mode the task blocks until the next state deadline
+ * (one wakeup per transition). A task notification wakes it early,
+ * e.g. when the system is resumed.
+ * 
  * @param pvParameters Pointer to SharedContext
  */
 void semaphoreControlTask(void* pvParameters) {
     SharedContext* context = static_cast<SharedContext*>(pvParameters);
 
     if (context == nullptr) {
-        Serial.println(F("[ERROR] Semaphore task: null context!"));
+        logMessage(LogLevel::ERROR, F("[ERROR] Semaphore task: null context!"));
         vTaskDelete(nullptr); // Remove the own task
         return;
     }
 
-    Serial.println(F("[TASK] Semaphore Control Task started"));
+    logMessage(LogLevel::INFO, F("[TASK] Semaphore Control Task started"));
 
     // Infinite loop of task
     for (;;) {
+        // Inactive system sleeps until notified
+        TickType_t sleepTicks = portMAX_DELAY;
+
         // Protection with mutex using RAII
         {
             ScopedLock lock(*context);
+            ProfiledSection profile(ProfiledTask::CONTROL);
 
             if (lock.isLocked() && context -> isSystemActive()) {
+                SemaphoreStateMachine& sm = context -> getStateMachine();
+
                 // Update the states machine
-                bool stateChanged = context -> getStateMachine().update();
+                bool stateChanged = sm.update();
 
                 // If happened state change, increments the contator
+                // and publish the new status to the monitor
                 if (stateChanged) {
                     context -> incrementTransitions();
+                    context -> publishSnapshot(uxTaskGetStackHighWaterMark(nullptr));
                 }
+
+                // Rounded up to the tick; a wakeup early by the elapsed part of the
+                // current tick only costs one more pass (no transition, sleep again)
+                sleepTicks = msToTicksCeil(sm.getTimeRemainingInState());
             }
         } // Lock is released automatically here (RAII)
 
-        // Yield to others tasks (cooperation)
-        // Small delay to don't overload the cpu
-        vTaskDelay(pdMS_TO_TICKS(10)); // 10ms
+        if (!RTOSConfig::ENABLE_DEADLINE_SCHEDULING) {
+            // Polling mode: small delay to don't overload the cpu
+            sleepTicks = pollPeriodTicks();
+        }
+
+        // Block until the deadline or an early notification
+        ulTaskNotifyTake(pdTRUE, sleepTicks);
+    }
+}
+
+/**
+ * @brief Human-readable status dump (bench debugging)
+ */
+void printTextStatus(const StatusSnapshot& snapshot) {
+    const uint32_t timeRemaining = snapshot.getTimeRemaining(millis());
+
+    // Display statistics (buffered, the UART never blocks the task)
+    LogRecord record(LogLevel::INFO);
+    record.println(F("\n========== SYSTEM STATUS =========="));
+    record.print(F("Current State: "));
+    record.println(toIndex(snapshot.state));
+
+    record.print(F("Time Remaining: "));
+    record.print(timeRemaining / 1000);
+    record.println(F("s"));
+
+    record.print(F("Cycle Count: "));
+    record.println(snapshot.cycleCount);
+
+    record.print(F("Total Transitions: "));
+    record.println(snapshot.totalTransitions);
+    
+    // Memory informations (debug)
+    record.print(F("Free Heap: "));
+    record.print(getFreeHeapSize());
+    record.println(F(" bytes"));
+
+    record.print(F("Log Dropped: "));
+    record.println(Logger::getDroppedLines());
+
+    if (RTOSConfig::ENABLE_TASK_PROFILING) {
+        TaskProfiler::printReport(record);
     }
+    
+    record.println(F("===================================\n"));
+}
+
+/**
+ * @brief Compact binary status frame (gateways), see Telemetry_Protocol.h
+ * Committed as one block, so it is never interleaved with text lines
+ */
+void sendBinaryStatus(const StatusSnapshot& snapshot, uint16_t sequence) {
+    TelemetryStatus status;
+    status.sequence = sequence;
+    status.state = snapshot.state;
+    status.timeRemainingMs = snapshot.getTimeRemaining(millis());
+    status.cycleCount = snapshot.cycleCount;
+    status.totalTransitions = snapshot.totalTransitions;
+    status.freeHeap = static_cast<uint16_t>(getFreeHeapSize());
+    status.controlStackWatermark = snapshot.controlStackWatermark;
+    status.monitorStackWatermark = static_cast<uint16_t>(uxTaskGetStackHighWaterMark(nullptr));
+
+    uint8_t frame[TelemetryEncoder::MAX_FRAME_SIZE];
+    const uint8_t length = TelemetryEncoder::encodeStatusFrame(status, frame);
+    Logger::commit(frame, length);
 }
 
 /**
@@ -190,66 +347,101 @@ void semaphoreControlTask(void* pvParameters) {
  * Display periodically informations about the system
  * (current state, remaining time, cycles, etc.)
  * 
+ * Read the status snapshot published by the control task and never
+ * take the control mutex, so the printing can't delay a transition.
+ * The output is text or binary frames (SerialConfig::TELEMETRY_FORMAT).
+ * 
  * @param pvParameters Pointer to SharedContext
  */
 void monitorTask(void* pvParameters) {
     SharedContext* context = static_cast<SharedContext*>(pvParameters);
 
     if (context == nullptr) {
-        Serial.println(F("[ERROR] Monitor task: null context!"));
+        logMessage(LogLevel::ERROR, F("[ERROR] Monitor task: null context!"));
         vTaskDelete(nullptr);
         return;
     }
 
-    Serial.println(F("[TASK] Monitor Task started"));
+    logMessage(LogLevel::INFO, F("[TASK] Monitor Task started"));
 
     TickType_t lastWakeTime = xTaskGetTickCount();
     const TickType_t period = pdMS_TO_TICKS(RTOSConfig::MONITOR_PERIOD_MS);
+    uint16_t sequence = 0; // Sequence number of the binary frames
     
     // Infinite loop of task
     for (;;) {
         // Await the next period (precise periodic execution)
-        vTaskDelete(&lastWakeTime, period);
+        vTaskDelayUntil(&lastWakeTime, period);
 
-        // Protection with mutex 
-        {
-            ScopedLock lock(*context);
+        if (!context -> isSystemActive()) {
+            continue;
+        }
 
-            if (lock.isLocked() && context -> isSystemActive()) {
-                SemaphoreStateMachine& sm = context -> getStateMachine();
+        ProfiledSection profile(ProfiledTask::MONITOR);
 
-                // Colect informations
-                SemaphoreState currentState = sm.getCurrentState();
-                uint32_t timeRemaining = sm.getTimeRemainingInState();
-                uint32_t cycleCount = sm.getCycleCount();
-                uint32_t totalTransitions = context ->  getTotalTransitions();
-
-                // Display statistics
-                Serial.println(F("\n========== SYSTEM STATUS =========="));
-                Serial.print(F("Current State: "));
-                Serial.println(toIndex(currentState));
-
-                Serial.print(F("Time Remaining: "));
-                Serial.print(timeRemaining / 1000);
-                Serial.println(F("s"));
-
-                Serial.print(F("Cycle Count: "));
-                Serial.println(cycleCount);
-
-                Serial.print(F("Total Transitions: "));
-                Serial.println(totalTransitions);
-                
-                // Memory informations (debug)
-                Serial.print(F("Free Heap: "));
-                Serial.print(xPortGetFreeHeapSize());
-                Serial.println(F(" byets"));
-                
-                Serial.println(F("===================================\n"));
-            }
+        // Colect informations (lock-free copy)
+        StatusSnapshot snapshot;
+        if (!context -> readSnapshot(snapshot)) {
+            continue;
+        }
+
+        if (SerialConfig::TELEMETRY_FORMAT == TelemetryFormat::BINARY) {
+            sendBinaryStatus(snapshot, sequence++);
+        } else {
+            printTextStatus(snapshot);
+        }
+    }
+}
+
+/**
+ * @brief Handle of the log drain task (woken by each log commit)
+ */
+namespace LogDrain {
+    TaskHandle_t taskHandle = nullptr;
+
+    inline void wake() {
+        if (taskHandle != nullptr) {
+            xTaskNotifyGive(taskHandle);
         }
     }
 }
 
+/**
+ * @brief Task of log drain
+ * 
+ * Flush the log ring buffer to the Serial only as fast as the TX buffer
+ * accepts, so the writers never wait on the UART. Lowest priority.
+ * 
+ * @param pvParameters Not used
+ */
+void logDrainTask(void* pvParameters) {
+    (void) pvParameters;
+
+    for (;;) {
+        {
+            ProfiledSection profile(ProfiledTask::LOG_DRAIN);
+            Logger::drain();
+        }
+
+        if (Logger::isEmpty()) {
+            // Sleep until a new line is committed
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        } else {
+            // TX buffer full: let the UART send it
+            vTaskDelay(1);
+        }
+    }
+}
+
+/**
+ * @brief Stack and control block arguments of TaskManager::spawnTask
+ */
+#if SEMAPHORE_STATIC_ALLOCATION
+#define SEMAPHORE_TASK_MEMORY(stack, buffer) stack, &buffer
+#else
+#define SEMAPHORE_TASK_MEMORY(stack, buffer) nullptr, nullptr
+#endif
+
 /**
  * @brief Tasks manager
  * 
@@ -260,7 +452,40 @@ private:
     SharedContext& context_;
     TaskHandle_t semaphoreTaskHandle_;
     TaskHandle_t monitorTaskHandle_;
+    TaskHandle_t logDrainTaskHandle_;
+    TaskFunction_t controlTaskFunction_;
+    void* controlTaskParameters_;
     bool tasksCreated_;
+
+#if SEMAPHORE_STATIC_ALLOCATION
+    // Stacks and control blocks of the tasks (sized at link time)
+    StackType_t semaphoreTaskStack_[RTOSConfig::SEMAPHORE_TASK_STACK_SIZE];
+    StackType_t monitorTaskStack_[RTOSConfig::MONITOR_TASK_STACK_SIZE];
+    StackType_t logDrainTaskStack_[RTOSConfig::LOG_DRAIN_TASK_STACK_SIZE];
+    StaticTask_t semaphoreTaskBuffer_;
+    StaticTask_t monitorTaskBuffer_;
+    StaticTask_t logDrainTaskBuffer_;
+#endif
+
+    /**
+     * @brief Create one task, with static or dynamic memory
+     * @return true if the task was created
+     */
+    static bool spawnTask(TaskFunction_t function, const char* name,
+                          uint16_t stackSize, void* parameters, UBaseType_t priority,
+                          StackType_t* stackBuffer, StaticTask_t* taskBuffer,
+                          TaskHandle_t& handle) {
+#if SEMAPHORE_STATIC_ALLOCATION
+        handle = xTaskCreateStatic(function, name, stackSize, parameters, priority,
+                                   stackBuffer, taskBuffer);
+        return handle != nullptr;
+#else
+        (void) stackBuffer;
+        (void) taskBuffer;
+        return xTaskCreate(function, name, stackSize, parameters, priority, &handle) == pdPASS;
+#endif
+    }
+
 public:
     /**
      * @brief Constructor
@@ -269,7 +494,19 @@ public:
         : context_(ctx),
           semaphoreTaskHandle_(nullptr),
           monitorTaskHandle_(nullptr),
+          logDrainTaskHandle_(nullptr),
+          controlTaskFunction_(semaphoreControlTask),
+          controlTaskParameters_(&ctx),
           tasksCreated_(false) {}
+
+    /**
+     * @brief Replace the control task (e.g. by the intersection scheduler)
+     * Must be called before createTasks()
+     */
+    void setControlTask(TaskFunction_t taskFunction, void* parameters) {
+        controlTaskFunction_ = taskFunction;
+        controlTaskParameters_ = parameters;
+    }
     
     /**
      * @brief Create and initiate all the tasks
@@ -277,51 +514,88 @@ public:
      */
     bool createTasks() {
         if (tasksCreated_) {
-            Serial.println(F("[WARN] Tasks already created!"));
+            logMessage(LogLevel::WARN, F("[WARN] Tasks already created!"));
             return true;
         }
 
-        BaseType_t result;
+        bool created;
 
         // Create the task of semaphore (higher priority)
-        result = xTaskCreate(
-            semaphoreControlTask,
+        created = spawnTask(
+            controlTaskFunction_,
             "SemaphoreCtrl",
             RTOSConfig::SEMAPHORE_TASK_STACK_SIZE,
-            &context_,
+            controlTaskParameters_,
             RTOSConfig::SEMAPHORE_TASK_PRIORITY,
-            &semaphoreTaskHandle_
+            SEMAPHORE_TASK_MEMORY(semaphoreTaskStack_, semaphoreTaskBuffer_),
+            semaphoreTaskHandle_
         );
 
-        if (result != pdPass) {
-            Serial.println(F("[ERROR] Failed to create Semaphore task!"));
+        if (!created) {
+            logMessage(LogLevel::ERROR, F("[ERROR] Failed to create Semaphore task!"));
             return false;
         }
+        TaskProfiler::registerTask(ProfiledTask::CONTROL, semaphoreTaskHandle_);
 
         // Create the monitoring task (lower priority)
-        result = xTaskCreate(
+        created = spawnTask(
             monitorTask,
             "Monitor",
             RTOSConfig::MONITOR_TASK_STACK_SIZE,
             &context_,
             RTOSConfig::MONITOR_TASK_PRIORITY,
-            &monitorTaskHandle_
+            SEMAPHORE_TASK_MEMORY(monitorTaskStack_, monitorTaskBuffer_),
+            monitorTaskHandle_
         );
 
-        if (result != pdPass) {
-            Serial.println(F("[ERROR] Failed to create Monitor task!"));
+        if (!created) {
+            logMessage(LogLevel::ERROR, F("[ERROR] Failed to create Monitor task!"));
             // Remove the semaphore task if monitor fail
             if (semaphoreTaskHandle_ != nullptr) {
                 vTaskDelete(semaphoreTaskHandle_);
+                semaphoreTaskHandle_ = nullptr;
+                TaskProfiler::registerTask(ProfiledTask::CONTROL, nullptr);
             }
             return false;
         }
+        TaskProfiler::registerTask(ProfiledTask::MONITOR, monitorTaskHandle_);
+
+        // Create the log drain task (lowest priority)
+        created = spawnTask(
+            logDrainTask,
+            "LogDrain",
+            RTOSConfig::LOG_DRAIN_TASK_STACK_SIZE,
+            nullptr,
+            RTOSConfig::LOG_DRAIN_TASK_PRIORITY,
+            SEMAPHORE_TASK_MEMORY(logDrainTaskStack_, logDrainTaskBuffer_),
+            logDrainTaskHandle_
+        );
+
+        if (!created) {
+            // Keep logging directly to the Serial
+            logMessage(LogLevel::WARN, F("[WARN] Failed to create LogDrain task, logging is blocking"));
+        } else {
+            // From now on the log lines are buffered
+            LogDrain::taskHandle = logDrainTaskHandle_;
+            Logger::attachDrain(LogDrain::wake);
+            TaskProfiler::registerTask(ProfiledTask::LOG_DRAIN, logDrainTaskHandle_);
+        }
 
-        taskCreated_ = true;
-        Serial.println(F("[INFO] All tasks created successfully!"));
+        tasksCreated_ = true;
+        logMessage(LogLevel::INFO, F("[INFO] All tasks created successfully!"));
         return true;
     }
 
+    /**
+     * @brief Wake the control task before its deadline
+     * Must be called after changing the state machine from outside the task
+     */
+    void notifyControlTask() {
+        if (semaphoreTaskHandle_ != nullptr) {
+            xTaskNotifyGive(semaphoreTaskHandle_);
+        }
+    }
+
     /**
      * @brief Suspend all the tasks
      */
@@ -334,22 +608,40 @@ public:
         }
 
         context_.setSystemActive(false);
-        Serial.println(F("[INFO] All tasks suspended"));
+        logMessage(LogLevel::INFO, F("[INFO] All tasks suspended"));
     }
 
     /**
      * @brief Summary all the tasks
      */
     void resumeAllTasks() {
+        // Activate first, so the control task computes its deadline when it runs
+        context_.setSystemActive(true);
+
         if (semaphoreTaskHandle_ != nullptr) {
             vTaskResume(semaphoreTaskHandle_);
         }
         if (monitorTaskHandle_ != nullptr) {
             vTaskResume(monitorTaskHandle_);
         }
-        
-        context_.setSystemActive(true);
-        Serial.println(F("[INFO] All tasks resumed")); 
+
+        notifyControlTask();
+        logMessage(LogLevel::INFO, F("[INFO] All tasks resumed")); 
+    }
+
+    /**
+     * @brief Stack high-water mark of one task (minimum free stack, in words)
+     * Compare with RTOSConfig stack sizes to resize them
+     */
+    UBaseType_t getStackHighWaterMark(ProfiledTask task) const {
+        return TaskProfiler::getStackHighWaterMark(task);
+    }
+
+    /**
+     * @brief Print the profile of all the tasks (stack, cpu upper bound, activations, mutex wait)
+     */
+    void printTaskProfile(Print& out) const {
+        TaskProfiler::printReport(out);
     }
 
     /**
@@ -14,112 +14,135 @@
 #include <Arduino.h>
 #include "Config.h"
 #include "Hardware_Abstraction_Layer.h"
+#include "Logger.h"
 
 namespace SemaphoreSystem {
 
+/**
+ * @brief States descriptions stored in program memory (PROGMEM)
+ */
+namespace StateDescriptions {
+    const char GREEN_CAR[] PROGMEM = "GREEN_CAR: Green to cars, red to pedestrians";
+    const char YELLOW_CAR[] PROGMEM = "YELLOW_CAR: Yellow to cars, red to pedestrians";
+    const char SAFETY_GAP_BEFORE[] PROGMEM = "SAFETY_GAP_BEFORE: All red (safety gap before changing to green for pedestrians)";
+    const char GREEN_PEDESTRIAN[] PROGMEM = "GREEN_PEDESTRIAN: Green to pedestrians, red to cars";
+    const char SAFETY_GAP_AFTER[] PROGMEM = "SAFETY_GAP_AFTER: All red (safety gap after changing to green for pedestrians)";
+}
+
 /**
  * @brief Semaphore state table (lookup table)
  * Constante configuration in program memory (PROGMEM)
- * to economize RAM
+ * to economize RAM. Must be read only through the accessors.
  */
 class StateTable{
 private:
-    static constexpr StateInfo stateTable_[5] = {
-        // 0 State: GREEN_CAR
-        StateInfo(
-            SemaphoreState::GREEN_CAR,
-            TimingConfig::GREEN_CAR_DURATION,
-            LedConfiguration(
-                LedStatus::OFF,    // redCar
-                LedStatus::OFF,    // yellowCar
-                LedStatus::ON,     // greenCar
-                LedStatus::ON,     // redPedestrian
-                LedStatus::OFF     // greenPedestrian
-            ),
-            "GREEN_CAR: Green to cars, red to pedestrians"
-        ),
-
-        // 1 State: YELLOW_CAR
-        StateInfo(
-            SemaphoreState::YELLOW_CAR,
-            TimingConfig::YELLOW_CAR_DURATION,
-            LedConfiguration(
-                LedStatus::OFF,    // redCar
-                LedStatus::ON,     // yellowCar
-                LedStatus::OFF,    // greenCar
-                LedStatus::ON,     // redPedestrian
-                LedStatus::OFF     // greenPedestrian
-            ),
-            "YELLOW_CAR: Yellow to cars, red to pedestrians"
-        ),
-
-        // 2 State: SAFETY_GAP_BEFORE
-        StateInfo(
-            SemaphoreState::SAFETY_GAP_BEFORE,
-            TimingConfig::SAFETY_GAP_DURATION,
-            LedConfiguration(
-                LedStatus::ON,     // redCar
-                LedStatus::OFF,    // yellowCar
-                LedStatus::OFF,    // greenCar
-                LedStatus::ON,     // redPedestrian
-                LedStatus::OFF     // greenPedestrian
-            ),
-            "SAFETY_GAP_BEFORE: All red (safety gap before changing to green for pedestrians)"
-        ),
-
-        // 3 State: GREEN_PEDESTRIAN
-        StateInfo(
-            SemaphoreState::GREEN_PEDESTRIAN,
-            TimingConfig::GREEN_PEDESTRIAN_DURATION,
-            LedConfiguration(
-                LedStatus::ON,     // redCar
-                LedStatus::OFF,    // yellowCar
-                LedStatus::OFF,    // greenCar
-                LedStatus::OFF,    // redPedestrian
-                LedStatus::ON      // greenPedestrian
-            ),
-            "GREEN_PEDESTRIAN: Green to pedestrians, red to cars"
-        ),
-
-        // 4 State: SAFETY_GAP_AFTER
-        StateInfo(
-            SemaphoreState::SAFETY_GAP_AFTER,
-            TimingConfig::SAFETY_GAP_DURATION,
-            LedConfiguration(
-                LedStatus::ON,     // redCar
-                LedStatus::OFF,    // yellowCar
-                LedStatus::OFF,    // greenCar
-                LedStatus::ON,     // redPedestrian
-                LedStatus::OFF     // greenPedestrian
-            ),
-            "SAFETY_GAP_AFTER: All red (safety gap after changing to green for pedestrians)"
-        )
-    };
+    static const StateInfo stateTable_[5];
 public:
     /**
-     * @brief Get informations of a specific state
+     * @brief Get informations of a specific state (copy from PROGMEM)
      */
-    static const StateInfo& getStateInfo(SemaphoreState state) {
-        return stateTable_[toIndex(state)];
+    static StateInfo getStateInfo(SemaphoreState state) {
+        StateInfo info(SemaphoreState::GREEN_CAR, 0, LedConfiguration(), nullptr);
+        memcpy_P(&info, &stateTable_[toIndex(state)], sizeof(StateInfo));
+        return info;
     }
 
     /**
      * @brief Get the state duration
      */
     static uint32_t getStateDuration(SemaphoreState state) {
-        return stateTable_[toIndex(state)].duration;
+        return pgm_read_dword(&stateTable_[toIndex(state)].duration);
     }
 
     /**
      * @brief Get the LED configuration for a specific state
      */
-    static const LedConfiguration& getLedConfiguration(SemaphoreState state) {
-        return stateTable_[toIndex(state)].ledConfig;
-    }    
+    static LedConfiguration getLedConfiguration(SemaphoreState state) {
+        return LedConfiguration::fromMask(
+            pgm_read_byte(&stateTable_[toIndex(state)].ledConfig.mask));
+    }
+
+    /**
+     * @brief Get the state description (PROGMEM string, printable with Serial)
+     */
+    static const __FlashStringHelper* getStateDescription(SemaphoreState state) {
+        return reinterpret_cast<const __FlashStringHelper*>(
+            pgm_read_ptr(&stateTable_[toIndex(state)].description));
+    }
 };
 
-// Static table definition
-constexpr StateInfo StateTable::stateTable_[5];
+// Static table definition (program memory)
+const StateInfo StateTable::stateTable_[5] PROGMEM = {
+    // 0 State: GREEN_CAR
+    StateInfo(
+        SemaphoreState::GREEN_CAR,
+        TimingConfig::GREEN_CAR_DURATION,
+        LedConfiguration(
+            LedStatus::OFF,    // redCar
+            LedStatus::OFF,    // yellowCar
+            LedStatus::ON,     // greenCar
+            LedStatus::ON,     // redPedestrian
+            LedStatus::OFF     // greenPedestrian
+        ),
+        StateDescriptions::GREEN_CAR
+    ),
+
+    // 1 State: YELLOW_CAR
+    StateInfo(
+        SemaphoreState::YELLOW_CAR,
+        TimingConfig::YELLOW_CAR_DURATION,
+        LedConfiguration(
+            LedStatus::OFF,    // redCar
+            LedStatus::ON,     // yellowCar
+            LedStatus::OFF,    // greenCar
+            LedStatus::ON,     // redPedestrian
+            LedStatus::OFF     // greenPedestrian
+        ),
+        StateDescriptions::YELLOW_CAR
+    ),
+
+    // 2 State: SAFETY_GAP_BEFORE
+    StateInfo(
+        SemaphoreState::SAFETY_GAP_BEFORE,
+        TimingConfig::SAFETY_GAP_DURATION,
+        LedConfiguration(
+            LedStatus::ON,     // redCar
+            LedStatus::OFF,    // yellowCar
+            LedStatus::OFF,    // greenCar
+            LedStatus::ON,     // redPedestrian
+            LedStatus::OFF     // greenPedestrian
+        ),
+        StateDescriptions::SAFETY_GAP_BEFORE
+    ),
+
+    // 3 State: GREEN_PEDESTRIAN
+    StateInfo(
+        SemaphoreState::GREEN_PEDESTRIAN,
+        TimingConfig::GREEN_PEDESTRIAN_DURATION,
+        LedConfiguration(
+            LedStatus::ON,     // redCar
+            LedStatus::OFF,    // yellowCar
+            LedStatus::OFF,    // greenCar
+            LedStatus::OFF,    // redPedestrian
+            LedStatus::ON      // greenPedestrian
+        ),
+        StateDescriptions::GREEN_PEDESTRIAN
+    ),
+
+    // 4 State: SAFETY_GAP_AFTER
+    StateInfo(
+        SemaphoreState::SAFETY_GAP_AFTER,
+        TimingConfig::SAFETY_GAP_DURATION,
+        LedConfiguration(
+            LedStatus::ON,     // redCar
+            LedStatus::OFF,    // yellowCar
+            LedStatus::OFF,    // greenCar
+            LedStatus::ON,     // redPedestrian
+            LedStatus::OFF     // greenPedestrian
+        ),
+        StateDescriptions::SAFETY_GAP_AFTER
+    )
+};
 
 /**
  * @brief Semaphore states machine 
@@ -139,7 +162,7 @@ private:
      * @brief Update the hardware with the current state's LED configuration
      */
     void updateHardware() {
-        const LedConfiguration& config = StateTable::getLedConfiguration(currentState_);
+        const LedConfiguration config = StateTable::getLedConfiguration(currentState_);
         hardwareController_.applyConfiguration(config);
     }
 
@@ -147,14 +170,15 @@ private:
      * @brief Register a state transition (to debug/logging)
      */
     void logStateChange() const {
-        if (SerialConfig::ENABLE_DEBUG) {
-            const StateInfo& info = StateTable::getStateInfo(currentState_);
-            Serial.print(F("[STATE] Cycle: "));
-            Serial.print(cycleCount_);
-            Serial.print(F(" | State: "));
-            Serial.print(toIndex(currentState_));
-            Serial.print(F(" | "));
-            Serial.println(info.description);
+        LogRecord record(LogLevel::DEBUG);
+
+        if (record) {
+            record.print(F("[STATE] Cycle: "));
+            record.print(cycleCount_);
+            record.print(F(" | State: "));
+            record.print(toIndex(currentState_));
+            record.print(F(" | "));
+            record.println(StateTable::getStateDescription(currentState_));
         }
 
     }
@@ -184,14 +208,25 @@ public:
     /**
      * @brief Start the state machine operation
      * Define the initial state and the reference time
+     * 
+     * @param phaseOffsetMs Start as if the cycle had already been running
+     *        for this time (used to coordinate intersections, "green wave")
      */
-    void begin() {
+    void begin(uint32_t phaseOffsetMs = 0) {
         if (!isInitialized_) {
             initialize();
         }
 
+        // Find the state and the elapsed time inside it for the offset
+        uint32_t offset = phaseOffsetMs % TimingConfig::TOTAL_CYCLE_DURATION;
         currentState_ = SemaphoreState::GREEN_CAR;
-        stateStartTime_ = millis();
+
+        while (offset >= StateTable::getStateDuration(currentState_)) {
+            offset -= StateTable::getStateDuration(currentState_);
+            ++currentState_;
+        }
+
+        stateStartTime_ = millis() - offset;
         cycleCount_ = 1;
 
         updateHardware();
@@ -227,6 +262,9 @@ public:
      * @brief Transition to the next state in the sequence
      */
     void transitionToNextState() {
+        const uint32_t currentTime = millis();
+        const uint32_t scheduledEnd = stateStartTime_ + StateTable::getStateDuration(currentState_);
+
         // Save the previous state for logging
         SemaphoreState previousState = currentState_;
 
@@ -239,8 +277,13 @@ public:
             cycleCount_++;   
         }
 
-        // Update the initial time for the new state
-        stateStartTime_ = millis();
+        // Anchor the new state on the scheduled deadline, so the wakeup latency
+        // of the caller does not accumulate over the cycle. Forced (early)
+        // transitions and long stalls restart the timing from now.
+        const uint32_t lateness = currentTime - scheduledEnd;
+        stateStartTime_ = (lateness < StateTable::getStateDuration(currentState_))
+                              ? scheduledEnd
+                              : currentTime;
 
         // Apply the new state's LED configuration to the hardware
         updateHardware();
@@ -265,6 +308,8 @@ public:
 
     /**
      * @brief Get the remaining time in the current state (in milliseconds)
+     * This is the time until the next transition, used by the control task
+     * to sleep exactly until the state deadline
      */
     uint32_t getTimeRemainingInState() const {
         const uint32_t elapsedTime = millis() - stateStartTime_;
@@ -277,15 +322,20 @@ public:
         return stateDuration - elapsedTime;
     }
 
+    /**
+     * @brief Get the absolute time (millis) of the next transition
+     */
+    uint32_t getStateDeadline() const {
+        return stateStartTime_ + StateTable::getStateDuration(currentState_);
+    }
+
     /**
      * @brief Emergency mode - turn off all
      */
     void emergencyStop() {
         hardwareController_.turnAllLedsOff();
 
-        if (SerialConfig::ENABLE_DEBUG) {
-            Serial.println(F("[EMERGENCY] All LEDs turned OFF"));
-        }
+        logMessage(LogLevel::WARN, F("[EMERGENCY] All LEDs turned OFF"));
     }
 
     /**
@@ -0,0 +1,108 @@
+/**
+ * @file Status_Snapshot.h
+ * @brief Lock-free status snapshot published by the control task
+ * @version 2.0.0
+ *
+ * The control task publishes an immutable copy of the system status
+ * through a sequence lock (seqlock). Readers (monitor/telemetry) never
+ * touch the control mutex, so printing can't delay a transition.
+ */
+
+#ifndef STATUS_SNAPSHOT_H
+#define STATUS_SNAPSHOT_H
+
+#include <Arduino.h>
+#include "Types.h"
+
+namespace SemaphoreSystem {
+
+/**
+ * @brief Compiler barrier: keep the memory accesses in program order
+ * Enough on single core MCUs (AVR), where the preemption is by software
+ */
+#define SNAPSHOT_MEMORY_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+/**
+ * @brief Status of the system in the moment of the publication
+ */
+struct StatusSnapshot {
+    SemaphoreState state;
+    uint32_t stateDeadline; // millis() of the next transition
+    uint32_t cycleCount;
+    uint32_t totalTransitions;
+    uint16_t controlStackWatermark; // Stack high-water mark of the control task
+
+    StatusSnapshot()
+        : state(SemaphoreState::GREEN_CAR),
+          stateDeadline(0),
+          cycleCount(0),
+          totalTransitions(0),
+          controlStackWatermark(0) {}
+
+    /**
+     * @brief Remaining time in the state at a given time (in milliseconds)
+     */
+    uint32_t getTimeRemaining(uint32_t currentTime) const {
+        const int32_t remaining = static_cast<int32_t>(stateDeadline - currentTime);
+        return remaining > 0 ? static_cast<uint32_t>(remaining) : 0;
+    }
+};
+
+/**
+ * @brief Single-writer seqlock channel of StatusSnapshot
+ *
+ * The sequence is odd while a publication is in progress. A reader
+ * retries if the sequence was odd or changed during its copy.
+ * uint8_t is used because it is read atomically on AVR.
+ */
+class SnapshotChannel {
+private:
+    volatile uint8_t sequence_;
+    StatusSnapshot snapshot_;
+
+public:
+    static constexpr uint8_t MAX_READ_ATTEMPTS = 4;
+
+    SnapshotChannel() : sequence_(0), snapshot_() {}
+
+    // Delete copy constructor and assignment operator
+    SnapshotChannel(const SnapshotChannel&) = delete;
+    SnapshotChannel& operator=(const SnapshotChannel&) = delete;
+
+    /**
+     * @brief Publish a new snapshot (only the control task writes)
+     */
+    void publish(const StatusSnapshot& snapshot) {
+        sequence_ = sequence_ + 1; // Odd: writing
+        SNAPSHOT_MEMORY_BARRIER();
+        snapshot_ = snapshot;
+        SNAPSHOT_MEMORY_BARRIER();
+        sequence_ = sequence_ + 1; // Even: consistent
+    }
+
+    /**
+     * @brief Read a consistent copy of the last snapshot
+     * @return false if no consistent copy was obtained (writer too busy)
+     */
+    bool read(StatusSnapshot& out) const {
+        for (uint8_t attempt = 0; attempt < MAX_READ_ATTEMPTS; attempt++) {
+            const uint8_t before = sequence_;
+            if (before & 1) {
+                continue;
+            }
+
+            SNAPSHOT_MEMORY_BARRIER();
+            out = snapshot_;
+            SNAPSHOT_MEMORY_BARRIER();
+
+            if (sequence_ == before) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+} // namespace SemaphoreSystem
+
+#endif // STATUS_SNAPSHOT_H
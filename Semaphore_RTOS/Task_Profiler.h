@@ -0,0 +1,220 @@
+/**
+ * @file Task_Profiler.h
+ * @brief Per-task runtime, stack and mutex wait profiling
+ * @version 2.0.0
+ *
+ * Measure each task of the system to size the stacks and the priorities
+ * from data instead of guesses:
+ *  - stack high-water mark (uxTaskGetStackHighWaterMark)
+ *  - CPU share: busy time of the task over the report window (upper bound)
+ *  - activations: ProfiledSection runs of the task (one per wakeup; not
+ *    the preemptions, so not the context switches)
+ *  - max wait time on the SharedContext mutex
+ *
+ * The time base is micros() (Timer0, 4us resolution on 16 MHz AVR).
+ * The busy time of a lower priority task also contains the preemptions
+ * by higher priority tasks, so it is an upper bound.
+ */
+
+#ifndef TASK_PROFILER_H
+#define TASK_PROFILER_H
+
+#include <Arduino.h>
+#include <Arduino_FreeRTOS.h>
+#include "Config.h"
+
+namespace SemaphoreSystem {
+
+/**
+ * @brief Tasks measured by the profiler
+ */
+enum class ProfiledTask : uint8_t {
+    CONTROL,
+    MONITOR,
+    LOG_DRAIN,
+    TOTAL_TASKS = 3
+};
+
+/**
+ * @brief Counters of one task
+ */
+struct TaskProfile {
+    uint32_t busyMicros;        // Busy time in the current window
+    uint16_t activations;       // ProfiledSection runs of the task in the current window
+    uint32_t maxLockWaitMicros; // Max wait on the mutex since the boot
+
+    TaskProfile()
+        : busyMicros(0),
+          activations(0),
+          maxLockWaitMicros(0) {}
+};
+
+/**
+ * @brief Global profiler (only static members, like the Logger)
+ *
+ * The counters are written by the tasks and read by the monitor, so all
+ * the accesses are inside short critical sections.
+ */
+class TaskProfiler {
+public:
+    static constexpr uint8_t TASK_COUNT = static_cast<uint8_t>(ProfiledTask::TOTAL_TASKS);
+
+private:
+    static TaskHandle_t handles_[TASK_COUNT];
+    static TaskProfile profiles_[TASK_COUNT];
+    static uint32_t windowStart_;
+
+    static uint8_t slotOf(ProfiledTask task) {
+        return static_cast<uint8_t>(task);
+    }
+
+    static const __FlashStringHelper* nameOf(uint8_t index) {
+        switch (static_cast<ProfiledTask>(index)) {
+            case ProfiledTask::CONTROL:   return F("Ctrl");
+            case ProfiledTask::MONITOR:   return F("Monitor");
+            case ProfiledTask::LOG_DRAIN: return F("LogDrain");
+            default:                      return F("?");
+        }
+    }
+
+public:
+    /**
+     * @brief Register the handle of a task (done by TaskManager)
+     */
+    static void registerTask(ProfiledTask task, TaskHandle_t handle) {
+        handles_[slotOf(task)] = handle;
+    }
+
+    static TaskHandle_t getHandle(ProfiledTask task) {
+        return handles_[slotOf(task)];
+    }
+
+    /**
+     * @brief Account one activation of a task and its busy time
+     */
+    static void recordActivation(ProfiledTask task, uint32_t busyMicros) {
+        if (!RTOSConfig::ENABLE_TASK_PROFILING) {
+            return;
+        }
+
+        TaskProfile& profile = profiles_[slotOf(task)];
+
+        const uint8_t oldSREG = SREG;
+        cli();
+        profile.busyMicros += busyMicros;
+        if (profile.activations < UINT16_MAX) {
+            profile.activations++;
+        }
+        SREG = oldSREG;
+    }
+
+    /**
+     * @brief Account a mutex wait of the calling task
+     * Unregistered callers (setup, loop) are ignored
+     */
+    static void recordLockWait(uint32_t waitMicros) {
+        if (!RTOSConfig::ENABLE_TASK_PROFILING) {
+            return;
+        }
+
+        const TaskHandle_t current = xTaskGetCurrentTaskHandle();
+
+        for (uint8_t i = 0; i < TASK_COUNT; i++) {
+            if (handles_[i] != nullptr && handles_[i] == current) {
+                const uint8_t oldSREG = SREG;
+                cli();
+                if (waitMicros > profiles_[i].maxLockWaitMicros) {
+                    profiles_[i].maxLockWaitMicros = waitMicros;
+                }
+                SREG = oldSREG;
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Stack high-water mark of a task (minimum free stack, in words)
+     */
+    static UBaseType_t getStackHighWaterMark(ProfiledTask task) {
+        const TaskHandle_t handle = handles_[slotOf(task)];
+        return handle != nullptr ? uxTaskGetStackHighWaterMark(handle) : 0;
+    }
+
+    /**
+     * @brief Print one line per task and start a new window
+     *
+     * Format: "<task> stk:<free> cpu<=<permille> act:<count> wait:<us>"
+     * cpu is an upper bound in per mille of the window (the busy time also
+     * holds the preemptions), act is the activations in the window
+     */
+    static void printReport(Print& out) {
+        const uint32_t now = micros();
+        const uint32_t windowMs = (now - windowStart_) / 1000;
+        windowStart_ = now;
+
+        out.println(F("Task Profile (cpu<= upper bound in 1/1000):"));
+
+        for (uint8_t i = 0; i < TASK_COUNT; i++) {
+            if (handles_[i] == nullptr) {
+                continue;
+            }
+
+            // Copy and reset the window counters
+            const uint8_t oldSREG = SREG;
+            cli();
+            const TaskProfile profile = profiles_[i];
+            profiles_[i].busyMicros = 0;
+            profiles_[i].activations = 0;
+            SREG = oldSREG;
+
+            // busy(us) / window(ms) = per mille, without 64-bit arithmetic
+            const uint32_t cpu = windowMs > 0 ? profile.busyMicros / windowMs : 0;
+
+            out.print(F("  "));
+            out.print(nameOf(i));
+            out.print(F(" stk:"));
+            out.print(uxTaskGetStackHighWaterMark(handles_[i]));
+            out.print(F(" cpu<="));
+            out.print(cpu);
+            out.print(F(" act:"));
+            out.print(profile.activations);
+            out.print(F(" wait:"));
+            out.print(profile.maxLockWaitMicros);
+            out.println(F("us"));
+        }
+    }
+};
+
+// Static members definition
+TaskHandle_t TaskProfiler::handles_[TaskProfiler::TASK_COUNT] = {nullptr, nullptr, nullptr};
+TaskProfile TaskProfiler::profiles_[TaskProfiler::TASK_COUNT];
+uint32_t TaskProfiler::windowStart_ = 0;
+
+/**
+ * @brief RAII measure of one activation of a task
+ * Place it around the work of the task, after the blocking call
+ */
+class ProfiledSection {
+private:
+    ProfiledTask task_;
+    uint32_t start_;
+
+public:
+    explicit ProfiledSection(ProfiledTask task)
+        : task_(task),
+          start_(RTOSConfig::ENABLE_TASK_PROFILING ? micros() : 0) {}
+
+    ~ProfiledSection() {
+        if (RTOSConfig::ENABLE_TASK_PROFILING) {
+            TaskProfiler::recordActivation(task_, micros() - start_);
+        }
+    }
+
+    // Delete copy constructor and assignment operator
+    ProfiledSection(const ProfiledSection&) = delete;
+    ProfiledSection& operator=(const ProfiledSection&) = delete;
+};
+
+} // namespace SemaphoreSystem
+
+#endif // TASK_PROFILER_H
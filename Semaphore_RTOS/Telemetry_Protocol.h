@@ -0,0 +1,149 @@
+/**
+ * @file Telemetry_Protocol.h
+ * @brief Compact binary telemetry frames (COBS framing + CRC-16)
+ * @version 2.0.0
+ *
+ * Alternative to the human-readable SYSTEM STATUS dump for gateways that
+ * scrape many controllers over a shared serial/RS-485 line.
+ *
+ * Frame on the wire: COBS(payload + CRC-16) followed by a 0x00 delimiter.
+ * Payload (little-endian, 23 bytes):
+ *   [0]     frame type (TELEMETRY_FRAME_STATUS)
+ *   [1]     protocol version
+ *   [2..3]  sequence number
+ *   [4]     semaphore state
+ *   [5..8]  time remaining in the state (ms)
+ *   [9..12] cycle count
+ *   [13..16] total transitions
+ *   [17..18] free heap (bytes)
+ *   [19..20] control task stack high-water mark
+ *   [21..22] monitor task stack high-water mark
+ * CRC: CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) over the payload.
+ */
+
+#ifndef TELEMETRY_PROTOCOL_H
+#define TELEMETRY_PROTOCOL_H
+
+#include <Arduino.h>
+#include "Types.h"
+
+namespace SemaphoreSystem {
+
+/**
+ * @brief Values carried by one status frame
+ */
+struct TelemetryStatus {
+    uint16_t sequence;
+    SemaphoreState state;
+    uint32_t timeRemainingMs;
+    uint32_t cycleCount;
+    uint32_t totalTransitions;
+    uint16_t freeHeap;
+    uint16_t controlStackWatermark;
+    uint16_t monitorStackWatermark;
+};
+
+/**
+ * @brief Encoder of the binary telemetry frames
+ */
+class TelemetryEncoder {
+public:
+    static constexpr uint8_t TELEMETRY_FRAME_STATUS = 0x01;
+    static constexpr uint8_t PROTOCOL_VERSION = 1;
+
+    static constexpr uint8_t STATUS_PAYLOAD_SIZE = 23;
+    static constexpr uint8_t CRC_SIZE = 2;
+
+    // COBS adds one byte per 254 bytes (plus one), and the 0x00 delimiter
+    static constexpr uint8_t MAX_FRAME_SIZE = STATUS_PAYLOAD_SIZE + CRC_SIZE + 2;
+
+    /**
+     * @brief CRC-16/CCITT-FALSE
+     */
+    static uint16_t crc16(const uint8_t* data, uint8_t length) {
+        uint16_t crc = 0xFFFF;
+
+        for (uint8_t i = 0; i < length; i++) {
+            crc ^= static_cast<uint16_t>(data[i]) << 8;
+            for (uint8_t bit = 0; bit < 8; bit++) {
+                crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021)
+                                     : static_cast<uint16_t>(crc << 1);
+            }
+        }
+        return crc;
+    }
+
+    /**
+     * @brief COBS encoding (Consistent Overhead Byte Stuffing)
+     * The output has no 0x00 bytes; the delimiter is appended
+     *
+     * @return Encoded length, including the 0x00 delimiter
+     */
+    static uint8_t cobsEncode(const uint8_t* input, uint8_t length, uint8_t* output) {
+        uint8_t codeIndex = 0;
+        uint8_t writeIndex = 1;
+        uint8_t code = 1;
+
+        for (uint8_t i = 0; i < length; i++) {
+            if (input[i] == 0) {
+                output[codeIndex] = code;
+                codeIndex = writeIndex++;
+                code = 1;
+            } else {
+                output[writeIndex++] = input[i];
+                code++;
+
+                if (code == 0xFF) {
+                    output[codeIndex] = code;
+                    codeIndex = writeIndex++;
+                    code = 1;
+                }
+            }
+        }
+
+        output[codeIndex] = code;
+        output[writeIndex++] = 0x00; // Frame delimiter
+        return writeIndex;
+    }
+
+    /**
+     * @brief Build a complete status frame
+     * @param frame Output buffer of at least MAX_FRAME_SIZE bytes
+     * @return Frame length
+     */
+    static uint8_t encodeStatusFrame(const TelemetryStatus& status, uint8_t* frame) {
+        uint8_t payload[STATUS_PAYLOAD_SIZE + CRC_SIZE];
+        uint8_t index = 0;
+
+        payload[index++] = TELEMETRY_FRAME_STATUS;
+        payload[index++] = PROTOCOL_VERSION;
+        index = putU16(payload, index, status.sequence);
+        payload[index++] = toIndex(status.state);
+        index = putU32(payload, index, status.timeRemainingMs);
+        index = putU32(payload, index, status.cycleCount);
+        index = putU32(payload, index, status.totalTransitions);
+        index = putU16(payload, index, status.freeHeap);
+        index = putU16(payload, index, status.controlStackWatermark);
+        index = putU16(payload, index, status.monitorStackWatermark);
+
+        index = putU16(payload, index, crc16(payload, STATUS_PAYLOAD_SIZE));
+
+        return cobsEncode(payload, index, frame);
+    }
+
+private:
+    static uint8_t putU16(uint8_t* buffer, uint8_t index, uint16_t value) {
+        buffer[index++] = static_cast<uint8_t>(value);
+        buffer[index++] = static_cast<uint8_t>(value >> 8);
+        return index;
+    }
+
+    static uint8_t putU32(uint8_t* buffer, uint8_t index, uint32_t value) {
+        index = putU16(buffer, index, static_cast<uint16_t>(value));
+        return putU16(buffer, index, static_cast<uint16_t>(value >> 16));
+    }
+};
+
+} // namespace SemaphoreSystem
+
+#endif // TELEMETRY_PROTOCOL_H
@@ -39,6 +39,25 @@ enum class LedStatus : bool {
     ON = true
 };
 
+/**
+ * @brief Severity of a log message (filtered by SerialConfig::LOG_LEVEL)
+ */
+enum class LogLevel : uint8_t {
+    DEBUG = 0,
+    INFO = 1,
+    WARN = 2,
+    ERROR = 3,
+    NONE = 4 // Disable all the messages
+};
+
+/**
+ * @brief Output format of the monitor telemetry
+ */
+enum class TelemetryFormat : uint8_t {
+    TEXT,  // Human-readable SYSTEM STATUS dump (bench debugging)
+    BINARY // Compact COBS framed packets (gateways), see Telemetry_Protocol.h
+};
+
 /**
  * @brief Semaphore type
  */
@@ -47,31 +66,97 @@ enum class SemaphoreType : uint8_t {
     PEDESTRIAN
 };
 
+/**
+ * @brief LEDs identifiers (bit position inside LedConfiguration)
+ */
+enum class LedId : uint8_t {
+    RED_CAR = 0,
+    YELLOW_CAR = 1,
+    GREEN_CAR = 2,
+    RED_PEDESTRIAN = 3,
+    GREEN_PEDESTRIAN = 4,
+
+    // Assistant value
+    TOTAL_LEDS = 5
+};
+
 /**
  * @brief Structure to represent the LEDs configuration to a state
- * Use safety and explicit types
+ * Packed as a one byte mask, one bit per LedId
  */
 struct LedConfiguration {
-    LedStatus redCar;
-    LedStatus yellowCar;
-    LedStatus greenCar;
-    LedStatus redPedestrian;
-    LedStatus greenPedestrian;
+    uint8_t mask;
 
     // Pattern constructor - all LEDs OFF
-    constexpr LedConfiguration()
-        : redCar(LedStatus::OFF),
-          yellowCar(LedStatus::OFF),
-          greenCar(LedStatus::OFF),
-          redPedestrian(LedStatus::OFF),
-          greenPedestrian(LedStatus::OFF) {}
+    constexpr LedConfiguration() : mask(0) {}
 
     // Parameterized constructor
     constexpr LedConfiguration(
         LedStatus rc, LedStatus yc, LedStatus gc,
         LedStatus rp, LedStatus gp
+    ) : mask(bitOf(rc, LedId::RED_CAR) |
+             bitOf(yc, LedId::YELLOW_CAR) |
+             bitOf(gc, LedId::GREEN_CAR) |
+             bitOf(rp, LedId::RED_PEDESTRIAN) |
+             bitOf(gp, LedId::GREEN_PEDESTRIAN)) {}
+
+    /**
+     * @brief Build a configuration from a raw mask (e.g. read from PROGMEM)
+     */
+    static constexpr LedConfiguration fromMask(uint8_t rawMask) {
+        return LedConfiguration(rawMask, 0);
+    }
+
+    /**
+     * @brief Get the status of a specific LED
+     */
+    constexpr LedStatus getStatus(LedId led) const {
+        return isOn(led) ? LedStatus::ON : LedStatus::OFF;
+    }
+
+    /**
+     * @brief Verify if a specific LED is ON
+     */
+    constexpr bool isOn(LedId led) const {
+        return (mask & (1u << static_cast<uint8_t>(led))) != 0;
+    }
+
+private:
+    // Raw mask constructor (the extra argument avoids ambiguity with integers)
+    constexpr LedConfiguration(uint8_t rawMask, int) : mask(rawMask) {}
+
+    static constexpr uint8_t bitOf(LedStatus status, LedId led) {
+        return status == LedStatus::ON ? static_cast<uint8_t>(1u << static_cast<uint8_t>(led)) : 0;
+    }
+};
+
+static_assert(sizeof(LedConfiguration) == 1, "LedConfiguration must stay packed in one byte");
+
+/**
+ * @brief Pins of the LEDs of one signal head (intersection)
+ */
+struct PinMap {
+    uint8_t redCar;
+    uint8_t yellowCar;
+    uint8_t greenCar;
+    uint8_t redPedestrian;
+    uint8_t greenPedestrian;
+
+    constexpr PinMap(
+        uint8_t rc, uint8_t yc, uint8_t gc,
+        uint8_t rp, uint8_t gp
     ) : redCar(rc), yellowCar(yc), greenCar(gc),
         redPedestrian(rp), greenPedestrian(gp) {}
+
+    /**
+     * @brief Get the pin of a specific LED
+     */
+    constexpr uint8_t pinOf(LedId led) const {
+        return led == LedId::RED_CAR ? redCar :
+               led == LedId::YELLOW_CAR ? yellowCar :
+               led == LedId::GREEN_CAR ? greenCar :
+               led == LedId::RED_PEDESTRIAN ? redPedestrian : greenPedestrian;
+    }
 };
 
 /**
@@ -81,7 +166,7 @@ struct StateInfo {
     SemaphoreState state;
     uint32_t duration; // Duration in milliseconds
     LedConfiguration ledConfig;
-    const char* description; // Description to debug/logging
+    const char* description; // Description to debug/logging (PROGMEM string)
 
     constexpr StateInfo (
         SemaphoreState s,
@@ -0,0 +1,157 @@
+/**
+ * @file Arduino.h
+ * @brief Minimal Arduino core for the host simulation
+ * @version 2.0.0
+ *
+ * Only what the Semaphore_RTOS headers use: integer types, PROGMEM
+ * access, F() strings, Print, the pins functions (no-ops) and the time
+ * functions, driven by HostSim::VirtualClock.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "Virtual_Clock.h"
+
+// ==================== PINS ====================
+
+#define LOW 0x0
+#define HIGH 0x1
+#define INPUT 0x0
+#define OUTPUT 0x1
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return LOW; }
+
+// ==================== TIME ====================
+
+inline uint32_t millis() { return HostSim::VirtualClock::millis(); }
+inline uint32_t micros() { return HostSim::VirtualClock::micros(); }
+inline void delay(uint32_t ms) { HostSim::VirtualClock::advanceMillis(ms); }
+
+// ==================== INTERRUPTS ====================
+
+// Single-threaded host: the critical sections have nothing to protect
+static uint8_t SREG __attribute__((unused)) = 0;
+inline void cli() {}
+inline void sei() {}
+
+// ==================== PROGMEM ====================
+
+#define PROGMEM
+#define PSTR(s) (s)
+
+inline uint8_t pgm_read_byte(const void* address) { return *static_cast<const uint8_t*>(address); }
+inline uint16_t pgm_read_word(const void* address) { return *static_cast<const uint16_t*>(address); }
+inline uint32_t pgm_read_dword(const void* address) { return *static_cast<const uint32_t*>(address); }
+inline const void* pgm_read_ptr(const void* address) { return *static_cast<const void* const*>(address); }
+inline void* memcpy_P(void* destination, const void* source, size_t size) { return memcpy(destination, source, size); }
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+
+// ==================== PRINT ====================
+
+#define DEC 10
+#define HEX 16
+
+/**
+ * @brief Subset of the Arduino Print class
+ */
+class Print {
+private:
+    size_t printNumber(unsigned long value, uint8_t base) {
+        char buffer[8 * sizeof(long) + 1];
+        char* cursor = &buffer[sizeof(buffer) - 1];
+        *cursor = '\0';
+
+        do {
+            const char digit = static_cast<char>(value % base);
+            *--cursor = digit < 10 ? digit + '0' : digit + 'A' - 10;
+            value /= base;
+        } while (value != 0);
+
+        return print(cursor);
+    }
+
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t written = 0;
+        while (size--) {
+            written += write(*buffer++);
+        }
+        return written;
+    }
+
+    virtual int availableForWrite() { return 0; }
+
+    size_t write(const char* text) {
+        return write(reinterpret_cast<const uint8_t*>(text), strlen(text));
+    }
+
+    size_t print(const char* text) { return write(text); }
+    size_t print(const __FlashStringHelper* text) { return print(reinterpret_cast<const char*>(text)); }
+    size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+    size_t print(unsigned char value, int base = DEC) { return print(static_cast<unsigned long>(value), base); }
+    size_t print(int value, int base = DEC) { return print(static_cast<long>(value), base); }
+    size_t print(unsigned int value, int base = DEC) { return print(static_cast<unsigned long>(value), base); }
+    size_t print(unsigned long value, int base = DEC) { return printNumber(value, static_cast<uint8_t>(base)); }
+
+    size_t print(long value, int base = DEC) {
+        if (value < 0 && base == DEC) {
+            return print('-') + printNumber(static_cast<unsigned long>(-value), DEC);
+        }
+        return printNumber(static_cast<unsigned long>(value), static_cast<uint8_t>(base));
+    }
+
+    size_t print(double value, int digits = 2) {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+        return print(buffer);
+    }
+
+    size_t println() { return write("\r\n"); }
+
+    template <typename T>
+    size_t println(T value) {
+        const size_t written = print(value);
+        return written + println();
+    }
+
+    template <typename T>
+    size_t println(T value, int format) {
+        const size_t written = print(value, format);
+        return written + println();
+    }
+};
+
+/**
+ * @brief Serial port of the host: the standard output
+ */
+class HostSerial : public Print {
+public:
+    void begin(unsigned long) {}
+
+    size_t write(uint8_t c) override {
+        return fputc(c, stdout) == EOF ? 0 : 1;
+    }
+
+    using Print::write;
+
+    int availableForWrite() override { return 64; }
+
+    explicit operator bool() const { return true; }
+};
+
+static HostSerial Serial;
+
+#endif // HOST_ARDUINO_H
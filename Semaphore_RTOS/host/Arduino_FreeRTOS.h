@@ -0,0 +1,62 @@
+/**
+ * @file Arduino_FreeRTOS.h
+ * @brief FreeRTOS stubs for the host simulation
+ * @version 2.0.0
+ *
+ * The host simulation is single-threaded: there is no scheduler, the
+ * tasks are never created and the blocking calls return at once. Only
+ * the types and the functions referenced by the headers are provided.
+ */
+
+#ifndef HOST_ARDUINO_FREERTOS_H
+#define HOST_ARDUINO_FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint8_t StackType_t;
+typedef int8_t BaseType_t;
+typedef uint8_t UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+struct StaticTask_t {
+    uint8_t reserved[32];
+};
+
+#define pdFALSE ((BaseType_t) 0)
+#define pdTRUE ((BaseType_t) 1)
+#define pdPASS (pdTRUE)
+#define pdFAIL (pdFALSE)
+
+#define portMAX_DELAY ((TickType_t) 0xffffffffUL)
+#define portTICK_PERIOD_MS ((TickType_t) 16) // WDT tick of the AVR port (~15 ms)
+#define pdMS_TO_TICKS(ms) ((TickType_t) (((TickType_t) (ms)) / portTICK_PERIOD_MS))
+
+#define configSUPPORT_STATIC_ALLOCATION 1
+#define configSUPPORT_DYNAMIC_ALLOCATION 1
+
+inline BaseType_t xTaskCreate(TaskFunction_t, const char*, uint16_t, void*, UBaseType_t, TaskHandle_t*) {
+    return pdFAIL;
+}
+
+inline TaskHandle_t xTaskCreateStatic(TaskFunction_t, const char*, uint16_t, void*, UBaseType_t,
+                                      StackType_t*, StaticTask_t*) {
+    return nullptr;
+}
+
+inline void vTaskDelete(TaskHandle_t) {}
+inline void vTaskSuspend(TaskHandle_t) {}
+inline void vTaskResume(TaskHandle_t) {}
+inline void vTaskDelay(TickType_t) {}
+inline void vTaskDelayUntil(TickType_t*, TickType_t) {}
+inline void vTaskStartScheduler() {}
+inline TickType_t xTaskGetTickCount() { return 0; }
+inline TaskHandle_t xTaskGetCurrentTaskHandle() { return nullptr; }
+inline UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t) { return 0; }
+inline uint32_t ulTaskNotifyTake(BaseType_t, TickType_t) { return 0; }
+inline BaseType_t xTaskNotifyGive(TaskHandle_t) { return pdPASS; }
+inline size_t xPortGetFreeHeapSize() { return 0; }
+
+#endif // HOST_ARDUINO_FREERTOS_H
@@ -0,0 +1,80 @@
+/**
+ * @file Mock_Hardware_Controller.h
+ * @brief IHardwareController what records the outputs instead of driving pins
+ * @version 2.0.0
+ */
+
+#ifndef MOCK_HARDWARE_CONTROLLER_H
+#define MOCK_HARDWARE_CONTROLLER_H
+
+#include <Arduino.h>
+#include "Hardware_Abstraction_Layer.h"
+
+namespace HostSim {
+
+using SemaphoreSystem::IHardwareController;
+using SemaphoreSystem::LedConfiguration;
+using SemaphoreSystem::LedStatus;
+
+/**
+ * @brief Mock of the hardware controller
+ * Keep the last configuration applied and the number of calls
+ */
+class MockHardwareController : public IHardwareController {
+private:
+    LedConfiguration lastConfiguration_;
+    uint32_t applyCount_;
+    uint32_t setLedCount_;
+    uint32_t allOffCount_;
+    bool initialized_;
+
+public:
+    MockHardwareController()
+        : lastConfiguration_(),
+          applyCount_(0),
+          setLedCount_(0),
+          allOffCount_(0),
+          initialized_(false) {}
+
+    void initialize() override {
+        initialized_ = true;
+    }
+
+    void setLedState(uint8_t, LedStatus) override {
+        setLedCount_++;
+    }
+
+    void applyConfiguration(const LedConfiguration& config) override {
+        lastConfiguration_ = config;
+        applyCount_++;
+    }
+
+    void turnAllLedsOff() override {
+        lastConfiguration_ = LedConfiguration();
+        allOffCount_++;
+    }
+
+    const LedConfiguration& getLastConfiguration() const {
+        return lastConfiguration_;
+    }
+
+    uint32_t getApplyCount() const {
+        return applyCount_;
+    }
+
+    uint32_t getSetLedCount() const {
+        return setLedCount_;
+    }
+
+    uint32_t getAllOffCount() const {
+        return allOffCount_;
+    }
+
+    bool isInitialized() const {
+        return initialized_;
+    }
+};
+
+} // namespace HostSim
+
+#endif // MOCK_HARDWARE_CONTROLLER_H
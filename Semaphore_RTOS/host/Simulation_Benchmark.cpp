@@ -0,0 +1,282 @@
+/**
+ * @file Simulation_Benchmark.cpp
+ * @brief Host simulation and benchmark of the state machine
+ * @version 2.0.0
+ *
+ * Run SemaphoreStateMachine, StateTable and SharedContext off-target,
+ * with a mock IHardwareController and a virtual clock, to catch the
+ * performance and timing regressions before flashing the boards:
+ *  1. Sequence check: LED outputs of each state against the StateTable
+ *  2. Throughput: simulated cycles per second (event-driven clock)
+ *  3. Micro-benchmarks: cost of update(), transitionToNextState(), etc.
+ *  4. Timing accuracy: the control task wakeups quantized to the RTOS
+ *     tick, lateness of each transition and drift of the cycle start,
+ *     crossing the millis() overflow
+ *
+ * Build and run (from the repository root):
+ *   g++ -std=gnu++11 -O2 -Wall -I Semaphore_RTOS/host -I Semaphore_RTOS \
+ *       Semaphore_RTOS/host/Simulation_Benchmark.cpp -o simulation_benchmark
+ *   ./simulation_benchmark [cycles]
+ *
+ * Exit code is not zero if a check failed.
+ */
+
+#include <Arduino.h>
+#include <Arduino_FreeRTOS.h>
+
+#include <chrono>
+#include <stdlib.h>
+
+#include "Config.h"
+#include "Types.h"
+#include "Semaphore_State_Machine.h"
+#include "SemaphoreTasks.h"
+#include "Virtual_Clock.h"
+#include "Mock_Hardware_Controller.h"
+
+using namespace SemaphoreSystem;
+using HostSim::MockHardwareController;
+using HostSim::VirtualClock;
+
+namespace {
+
+constexpr uint32_t DEFAULT_CYCLES = 1000000;
+constexpr uint32_t MICRO_BENCHMARK_ITERATIONS = 5000000;
+constexpr uint32_t TIMING_CYCLES = 10000;
+
+// Tolerated lateness of a transition: the rounding to the tick
+constexpr uint32_t MAX_LATENESS_MS = portTICK_PERIOD_MS;
+
+// Avoid the optimization of the measured calls
+volatile uint32_t g_sink = 0;
+
+using BenchmarkClock = std::chrono::steady_clock;
+
+double secondsSince(BenchmarkClock::time_point start) {
+    return std::chrono::duration<double>(BenchmarkClock::now() - start).count();
+}
+
+/**
+ * @brief Measure the mean cost of an operation in nanoseconds
+ */
+template <typename Operation>
+double nanosecondsPerOperation(uint32_t iterations, Operation operation) {
+    const BenchmarkClock::time_point start = BenchmarkClock::now();
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        operation();
+    }
+
+    return secondsSince(start) * 1e9 / iterations;
+}
+
+/**
+ * @brief Jump the clock to the next deadline and update (one transition)
+ */
+bool stepToNextTransition(SemaphoreStateMachine& stateMachine) {
+    VirtualClock::advanceToMillis(stateMachine.getStateDeadline());
+    return stateMachine.update();
+}
+
+// ==================== 1. SEQUENCE CHECK ====================
+
+bool checkSequence(uint32_t cycles) {
+    MockHardwareController hardware;
+    SemaphoreStateMachine stateMachine(hardware);
+    VirtualClock::setMillis(0);
+
+    stateMachine.initialize();
+    stateMachine.begin();
+
+    uint32_t errors = 0;
+    SemaphoreState expected = SemaphoreState::GREEN_CAR;
+    const uint32_t transitions = cycles * toIndex(SemaphoreState::TOTAL_STATES);
+
+    for (uint32_t i = 0; i < transitions; i++) {
+        if (stateMachine.getCurrentState() != expected ||
+            hardware.getLastConfiguration().mask != StateTable::getLedConfiguration(expected).mask) {
+            errors++;
+        }
+
+        if (!stepToNextTransition(stateMachine)) {
+            errors++;
+        }
+        ++expected;
+    }
+
+    const bool passed = errors == 0 &&
+                        hardware.isInitialized() &&
+                        stateMachine.getCycleCount() == cycles + 1 &&
+                        hardware.getApplyCount() == transitions + 1;
+
+    printf("[SEQUENCE] %u cycles, %u errors, %u outputs: %s\n",
+           static_cast<unsigned>(cycles),
+           static_cast<unsigned>(errors),
+           static_cast<unsigned>(hardware.getApplyCount()),
+           passed ? "OK" : "FAIL");
+
+    return passed;
+}
+
+// ==================== 2. THROUGHPUT ====================
+
+void measureThroughput(uint32_t cycles) {
+    MockHardwareController hardware;
+    SemaphoreStateMachine stateMachine(hardware);
+    VirtualClock::setMillis(0);
+
+    stateMachine.initialize();
+    stateMachine.begin();
+
+    const uint32_t transitions = cycles * toIndex(SemaphoreState::TOTAL_STATES);
+    const BenchmarkClock::time_point start = BenchmarkClock::now();
+
+    for (uint32_t i = 0; i < transitions; i++) {
+        stepToNextTransition(stateMachine);
+    }
+
+    const double seconds = secondsSince(start);
+
+    printf("[THROUGHPUT] %u cycles in %.3f s: %.0f cycles/s (%.1f simulated days)\n",
+           static_cast<unsigned>(cycles),
+           seconds,
+           cycles / seconds,
+           cycles * (TimingConfig::TOTAL_CYCLE_DURATION / 1000.0) / 86400.0);
+}
+
+// ==================== 3. MICRO-BENCHMARKS ====================
+
+void runMicroBenchmarks() {
+    MockHardwareController hardware;
+    SemaphoreStateMachine stateMachine(hardware);
+    SharedContext context(stateMachine);
+    VirtualClock::setMillis(0);
+
+    stateMachine.initialize();
+    stateMachine.begin();
+
+    // Hot path of the polling mode: nothing to do
+    const double updateIdle = nanosecondsPerOperation(MICRO_BENCHMARK_ITERATIONS, [&]() {
+        g_sink += stateMachine.update();
+    });
+
+    const double transition = nanosecondsPerOperation(MICRO_BENCHMARK_ITERATIONS, [&]() {
+        stateMachine.transitionToNextState();
+    });
+
+    const double updateDue = nanosecondsPerOperation(MICRO_BENCHMARK_ITERATIONS, [&]() {
+        g_sink += stepToNextTransition(stateMachine);
+    });
+
+    const double remaining = nanosecondsPerOperation(MICRO_BENCHMARK_ITERATIONS, [&]() {
+        g_sink += stateMachine.getTimeRemainingInState();
+    });
+
+    const double tableLookup = nanosecondsPerOperation(MICRO_BENCHMARK_ITERATIONS, [&]() {
+        g_sink += StateTable::getStateDuration(static_cast<SemaphoreState>(g_sink % 5));
+    });
+
+    StatusSnapshot snapshot;
+    const double publishRead = nanosecondsPerOperation(MICRO_BENCHMARK_ITERATIONS, [&]() {
+        ScopedLock lock(context);
+        context.publishSnapshot();
+        g_sink += context.readSnapshot(snapshot);
+    });
+
+    printf("[BENCH] update() idle:             %8.2f ns\n", updateIdle);
+    printf("[BENCH] update() due:              %8.2f ns\n", updateDue);
+    printf("[BENCH] transitionToNextState():   %8.2f ns\n", transition);
+    printf("[BENCH] getTimeRemainingInState(): %8.2f ns\n", remaining);
+    printf("[BENCH] StateTable duration:       %8.2f ns\n", tableLookup);
+    printf("[BENCH] lock + publish + read:     %8.2f ns\n", publishRead);
+}
+
+// ==================== 4. TIMING ACCURACY ====================
+
+/**
+ * @brief Emulate the control task with wakeups on the RTOS tick
+ *
+ * @param deadlineScheduling Sleep until the deadline (else poll)
+ * @param startMillis millis() at the start (near the overflow to cross it)
+ */
+bool checkTimingAccuracy(bool deadlineScheduling, uint32_t startMillis) {
+    MockHardwareController hardware;
+    SemaphoreStateMachine stateMachine(hardware);
+    VirtualClock::setMillis(startMillis);
+
+    stateMachine.initialize();
+    stateMachine.begin();
+
+    const uint32_t firstCycleStart = millis();
+    uint32_t lastCycleStart = firstCycleStart;
+    uint32_t completedCycles = 0;
+
+    uint32_t transitions = 0;
+    uint32_t maxLateness = 0;
+    uint64_t totalLateness = 0;
+
+    // Tick counter of the RTOS, from the start of the simulation
+    uint32_t tick = 0;
+
+    while (completedCycles < TIMING_CYCLES) {
+        const uint32_t deadline = stateMachine.getStateDeadline();
+
+        if (stateMachine.update()) {
+            const uint32_t lateness = millis() - deadline;
+            maxLateness = lateness > maxLateness ? lateness : maxLateness;
+            totalLateness += lateness;
+            transitions++;
+
+            if (stateMachine.getCurrentState() == SemaphoreState::GREEN_CAR) {
+                completedCycles++;
+                // Anchored start of the new cycle (deadline, not wakeup time)
+                lastCycleStart = deadline;
+            }
+        }
+
+        const TickType_t sleepTicks = deadlineScheduling
+            ? msToTicksCeil(stateMachine.getTimeRemainingInState())
+            : pollPeriodTicks();
+
+        tick += sleepTicks;
+        VirtualClock::setMillis(startMillis + tick * portTICK_PERIOD_MS);
+    }
+
+    // Drift: real start of the last cycle against the ideal one
+    const int32_t drift = static_cast<int32_t>(
+        (lastCycleStart - firstCycleStart) - completedCycles * TimingConfig::TOTAL_CYCLE_DURATION);
+
+    const bool passed = maxLateness <= MAX_LATENESS_MS && drift == 0;
+
+    printf("[TIMING] %s, start %lu: %u transitions, lateness mean %.2f ms max %u ms, drift %d ms: %s\n",
+           deadlineScheduling ? "deadline" : "polling ",
+           static_cast<unsigned long>(startMillis),
+           static_cast<unsigned>(transitions),
+           transitions > 0 ? static_cast<double>(totalLateness) / transitions : 0.0,
+           static_cast<unsigned>(maxLateness),
+           static_cast<int>(drift),
+           passed ? "OK" : "FAIL");
+
+    return passed;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const uint32_t cycles = argc > 1 ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 10)) : DEFAULT_CYCLES;
+
+    bool passed = true;
+
+    passed &= checkSequence(1000);
+    measureThroughput(cycles);
+    runMicroBenchmarks();
+
+    // Near the millis() overflow (~49.7 days) to cross it during the run
+    const uint32_t nearOverflow = UINT32_MAX - 10 * TimingConfig::TOTAL_CYCLE_DURATION;
+    passed &= checkTimingAccuracy(true, 0);
+    passed &= checkTimingAccuracy(true, nearOverflow);
+    passed &= checkTimingAccuracy(false, nearOverflow);
+
+    printf("%s\n", passed ? "ALL CHECKS PASSED" : "SOME CHECKS FAILED");
+    return passed ? 0 : 1;
+}
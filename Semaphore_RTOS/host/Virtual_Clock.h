@@ -0,0 +1,62 @@
+/**
+ * @file Virtual_Clock.h
+ * @brief Virtual time base of the host simulation
+ * @version 2.0.0
+ *
+ * Replace the Timer0 of the board: millis() and micros() of the host
+ * Arduino.h read this clock, and the simulation moves it forward.
+ */
+
+#ifndef VIRTUAL_CLOCK_H
+#define VIRTUAL_CLOCK_H
+
+#include <stdint.h>
+
+namespace HostSim {
+
+/**
+ * @brief Simulated time in microseconds (only static members)
+ * Wraps like the real millis()/micros() counters
+ */
+class VirtualClock {
+private:
+    static uint64_t nowMicros_;
+
+public:
+    static uint32_t millis() {
+        return static_cast<uint32_t>(nowMicros_ / 1000);
+    }
+
+    static uint32_t micros() {
+        return static_cast<uint32_t>(nowMicros_);
+    }
+
+    /**
+     * @brief Move the time forward
+     */
+    static void advanceMillis(uint32_t ms) {
+        nowMicros_ += static_cast<uint64_t>(ms) * 1000;
+    }
+
+    /**
+     * @brief Jump to an absolute time (in milliseconds)
+     * Used to start the simulation near the millis() overflow
+     */
+    static void setMillis(uint32_t ms) {
+        nowMicros_ = static_cast<uint64_t>(ms) * 1000;
+    }
+
+    /**
+     * @brief Jump forward to an absolute millis() value (wrap aware)
+     */
+    static void advanceToMillis(uint32_t ms) {
+        advanceMillis(ms - millis());
+    }
+};
+
+// Static member definition (the host build is a single translation unit)
+uint64_t VirtualClock::nowMicros_ = 0;
+
+} // namespace HostSim
+
+#endif // VIRTUAL_CLOCK_H
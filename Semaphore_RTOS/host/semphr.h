@@ -0,0 +1,56 @@
+/**
+ * @file semphr.h
+ * @brief FreeRTOS mutex stubs for the host simulation
+ * @version 2.0.0
+ *
+ * Single-threaded host: a mutex is only a flag, so a missing unlock (or a
+ * double lock) makes the next take fail, like a real timeout would.
+ */
+
+#ifndef HOST_SEMPHR_H
+#define HOST_SEMPHR_H
+
+#include "Arduino_FreeRTOS.h"
+
+struct StaticSemaphore_t {
+    bool taken;
+    bool dynamic;
+};
+
+typedef StaticSemaphore_t* SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t* buffer) {
+    buffer->taken = false;
+    buffer->dynamic = false;
+    return buffer;
+}
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() {
+    SemaphoreHandle_t mutex = xSemaphoreCreateMutexStatic(new StaticSemaphore_t);
+    mutex->dynamic = true;
+    return mutex;
+}
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t) {
+    if (mutex->taken) {
+        return pdFALSE;
+    }
+    mutex->taken = true;
+    return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex) {
+    if (!mutex->taken) {
+        return pdFALSE;
+    }
+    mutex->taken = false;
+    return pdTRUE;
+}
+
+inline void vSemaphoreDelete(SemaphoreHandle_t mutex) {
+    if (mutex->dynamic) {
+        delete mutex;
+    }
+}
+
+#endif // HOST_SEMPHR_H
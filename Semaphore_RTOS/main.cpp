@@ -26,6 +26,8 @@
 #include "Hardware_Abstraction_Layer.h"
 #include "Semaphore_State_Machine.h"
 #include "SemaphoreTasks.h"
+#include "Intersection_Scheduler.h"
+#include "Logger.h"
 
 // System namespace
 using namespace SemaphoreSystem;
@@ -33,67 +35,91 @@ using namespace SemaphoreSystem;
 // ==================== GLOBALS VARIABLES ====================
 
 // Principals instances of system (global necessary scope to FreeRTOS)
+// Allocated in the heap, or statically with SEMAPHORE_STATIC_ALLOCATION
 
 ArduinoHardwareController* g_hardwareController = nullptr;
 SemaphoreStateMachine* g_stateMachine = nullptr;
 SharedContext* g_sharedContext = nullptr;
 TaskManager* g_taskManager = nullptr;
 
+// Multi-intersection mode (IntersectionConfig::ENABLE_MULTI_INTERSECTION)
+using Scheduler = IntersectionScheduler<IntersectionConfig::INTERSECTION_COUNT>;
+Scheduler* g_scheduler = nullptr;
+
 // ==================== AUXILIARIES FUNCTIONS ====================
 
+/**
+ * @brief Apply one LED configuration to every signal head of the scheduler
+ * Drives the hardware directly (no state machine, no log): also usable
+ * from the FreeRTOS hooks
+ */
+void applyToAllIntersections(const LedConfiguration& config) {
+    if (g_scheduler == nullptr) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < Scheduler::size(); i++) {
+        g_scheduler->getHardware(i).applyConfiguration(config);
+    }
+}
+
 /**
  * @brief Print banner of initialization
  */
 void printStartupBanner() {
-    Serial.println(F("\n"));
-    Serial.println(F("╔════════════════════════════════════════════╗"));
-    Serial.println(F("║   TRAFFIC LIGHT CONTROL SYSTEM v2.0       ║"));
-    Serial.println(F("║   With FreeRTOS & Clean Architecture      ║"));
-    Serial.println(F("╚════════════════════════════════════════════╝"));
-    Serial.println(F(""));
-    Serial.println(F("System Configuration:"));
-    Serial.print(F("  - Green Car Duration: "));
-    Serial.print(TimingConfig::GREEN_CAR_DURATION / 1000);
-    Serial.println(F("s"));
-
-    Serial.print(F("  - Yellow Car Duration: "));
-    Serial.print(TimingConfig::YELLOW_CAR_DURATION / 1000);
-    Serial.println(F("s"));
-
-    Serial.print(F("  - Safety Gap Duration: "));
-    Serial.print(TimingConfig::SAFETY_GAP_DURATION / 1000);
-    Serial.println(F("s"));
-
-    Serial.print(F("  - Green Pedestrian Duration: "));
-    Serial.print(TimingConfig::GREEN_PEDESTRIAN_DURATION / 1000);
-    Serial.println(F("s"));
-
-    Serial.print(F("  - Total Cycle Time: "));
-    Serial.print(TimingConfig::TOTAL_CYCLE_TIME / 1000);
-    Serial.println(F("s"));
-
-    Serial.println(F(""));
+    LogRecord record(LogLevel::INFO);
+
+    record.println(F("\n"));
+    record.println(F("╔════════════════════════════════════════════╗"));
+    record.println(F("║   TRAFFIC LIGHT CONTROL SYSTEM v2.0       ║"));
+    record.println(F("║   With FreeRTOS & Clean Architecture      ║"));
+    record.println(F("╚════════════════════════════════════════════╝"));
+    record.println(F(""));
+    record.println(F("System Configuration:"));
+    record.print(F("  - Green Car Duration: "));
+    record.print(TimingConfig::GREEN_CAR_DURATION / 1000);
+    record.println(F("s"));
+
+    record.print(F("  - Yellow Car Duration: "));
+    record.print(TimingConfig::YELLOW_CAR_DURATION / 1000);
+    record.println(F("s"));
+
+    record.print(F("  - Safety Gap Duration: "));
+    record.print(TimingConfig::SAFETY_GAP_DURATION / 1000);
+    record.println(F("s"));
+
+    record.print(F("  - Green Pedestrian Duration: "));
+    record.print(TimingConfig::GREEN_PEDESTRIAN_DURATION / 1000);
+    record.println(F("s"));
+
+    record.print(F("  - Total Cycle Time: "));
+    record.print(TimingConfig::TOTAL_CYCLE_DURATION / 1000);
+    record.println(F("s"));
+
+    record.println(F(""));
 }
 
 /**
  * @brief Print configurations of pins
  */
 void printPinConfiguration() {
-    Serial.println(F("Pin Configuration:"));
-    Serial.println(F("  Vehicle LEDs:"));
-    Serial.print(F("    - Red: Pin "));
-    Serial.println(HardwareConfig::LED_RED_CAR);
-    Serial.print(F("    - Yellow: Pin "));
-    Serial.println(HardwareConfig::LED_YELLOW_CAR);
-    Serial.print(F("    - Green: Pin "));
-    Serial.println(HardwareConfig::LED_GREEN_CAR);
+    LogRecord record(LogLevel::INFO);
+
+    record.println(F("Pin Configuration:"));
+    record.println(F("  Vehicle LEDs:"));
+    record.print(F("    - Red: Pin "));
+    record.println(HardwareConfig::LED_RED_CAR);
+    record.print(F("    - Yellow: Pin "));
+    record.println(HardwareConfig::LED_YELLOW_CAR);
+    record.print(F("    - Green: Pin "));
+    record.println(HardwareConfig::LED_GREEN_CAR);
     
-    Serial.println(F("  Pedestrian LEDs:"));
-    Serial.print(F("    - Red: Pin "));
-    Serial.println(HardwareConfig::LED_RED_PEDESTRIAN);
-    Serial.print(F("    - Green: Pin "));
-    Serial.println(HardwareConfig::LED_GREEN_PEDESTRIAN);
-    Serial.println(F(""));
+    record.println(F("  Pedestrian LEDs:"));
+    record.print(F("    - Red: Pin "));
+    record.println(HardwareConfig::LED_RED_PEDESTRIAN);
+    record.print(F("    - Green: Pin "));
+    record.println(HardwareConfig::LED_GREEN_PEDESTRIAN);
+    record.println(F(""));
 }
 
 /**
@@ -101,19 +127,60 @@ void printPinConfiguration() {
  * @return true if the initialization was successful
  */
 bool initializeHardware() {
-    Serial.println(F("[INIT] Initializing hardware..."));
+    logMessage(LogLevel::INFO, F("[INIT] Initializing hardware..."));
+
+    // The intersection scheduler owns the pins of every signal head
+    // (intersection 0 is on the HardwareConfig pins): no singleton
+    if (IntersectionConfig::ENABLE_MULTI_INTERSECTION) {
+        logMessage(LogLevel::INFO, F("[OK] Hardware owned by the intersection scheduler"));
+        return true;
+    }
 
     // Get the instance singleton of hardware controller
     g_hardwareController = &ArduinoHardwareController::getInstance();
 
     if (g_hardwareController == nullptr) {
-        Serial.println(F("[ERROR] Failed to get hardware controller instance!"));
+        logMessage(LogLevel::ERROR, F("[ERROR] Failed to get hardware controller instance!"));
         return false;
     }
 
     // Initialize the hardware
     g_hardwareController->initialize();
-    Serial.println(F("[OK] Hardware initialized successfully"));
+    logMessage(LogLevel::INFO, F("[OK] Hardware initialized successfully"));
+
+    return true;
+}
+
+/**
+ * @brief Initialize the scheduler of several intersections
+ * The first intersection is the one reported by the monitor
+ * @return true if the initialization was successful
+ */
+bool initializeIntersectionScheduler() {
+    logMessage(LogLevel::INFO, F("[INIT] Initializing intersection scheduler..."));
+
+#if SEMAPHORE_STATIC_ALLOCATION
+    static Scheduler scheduler;
+    g_scheduler = &scheduler;
+#else
+    g_scheduler = new Scheduler();
+#endif
+
+    if (g_scheduler == nullptr) {
+        logMessage(LogLevel::ERROR, F("[ERROR] Failed to create intersection scheduler!"));
+        return false;
+    }
+
+    for (uint8_t i = 0; i < Scheduler::size(); i++) {
+        g_scheduler->configure(i,
+                               IntersectionConfig::INTERSECTION_PINS[i],
+                               IntersectionConfig::PHASE_OFFSETS_MS[i]);
+    }
+
+    g_scheduler->begin();
+    g_stateMachine = &g_scheduler->getStateMachine(0);
+
+    logMessage(LogLevel::INFO, F("[OK] Intersection scheduler initialized successfully"));
 
     return true;
 }
@@ -123,18 +190,27 @@ bool initializeHardware() {
  * @return true if the initialization was successful
  */
 bool initializeStateMachine() {
-    Serial.println(F("[INIT] Initializing state machine..."));
+    logMessage(LogLevel::INFO, F("[INIT] Initializing state machine..."));
+
+    if (IntersectionConfig::ENABLE_MULTI_INTERSECTION) {
+        return initializeIntersectionScheduler();
+    }
 
     if (g_hardwareController == nullptr) {
-        Serial.println(F("[ERROR] Hardware controller not initialized!"));
+        logMessage(LogLevel::ERROR, F("[ERROR] Hardware controller not initialized!"));
         return false;
     }
 
     // Create the machine of states
+#if SEMAPHORE_STATIC_ALLOCATION
+    static SemaphoreStateMachine stateMachine(*g_hardwareController);
+    g_stateMachine = &stateMachine;
+#else
     g_stateMachine = new SemaphoreStateMachine(*g_hardwareController);
+#endif
 
     if (g_stateMachine == nullptr) {
-        Serial.println(F("[ERROR] Failed to create state machine instance!"));
+        logMessage(LogLevel::ERROR, F("[ERROR] Failed to create state machine instance!"));
         return false;
     }
 
@@ -142,7 +218,7 @@ bool initializeStateMachine() {
     g_stateMachine->initialize();
     g_stateMachine->begin();
 
-    Serial.println(F("[OK] State machine initialized successfully"));
+    logMessage(LogLevel::INFO, F("[OK] State machine initialized successfully"));
 
     return true;
 }
@@ -152,22 +228,27 @@ bool initializeStateMachine() {
  * @return true if the initialization was successful
  */
 bool initializeSharedContext() {
-    Serial.println(F("[INIT] Initializing shared context..."));
+    logMessage(LogLevel::INFO, F("[INIT] Initializing shared context..."));
 
     if (g_stateMachine == nullptr) {
-        Serial.println(F("[ERROR] State machine not initialized!"));
+        logMessage(LogLevel::ERROR, F("[ERROR] State machine not initialized!"));
         return false;
     }
 
     // Create the shared context
+#if SEMAPHORE_STATIC_ALLOCATION
+    static SharedContext sharedContext(*g_stateMachine);
+    g_sharedContext = &sharedContext;
+#else
     g_sharedContext = new SharedContext(*g_stateMachine);
+#endif
 
     if (g_sharedContext == nullptr) {
-        Serial.println(F("[ERROR] Failed to create shared context!"));
+        logMessage(LogLevel::ERROR, F("[ERROR] Failed to create shared context!"));
         return false;
     }
 
-    Serial.println(F("[OK] Shared context initialized successfully"));
+    logMessage(LogLevel::INFO, F("[OK] Shared context initialized successfully"));
 
     return true;
 }
@@ -177,28 +258,40 @@ bool initializeSharedContext() {
  * @return true if the initialization was successful
  */
 bool initializeTasks() {
-    Serial.println(F("[INIT] Creating FreeRTOS tasks..."));
+    logMessage(LogLevel::INFO, F("[INIT] Creating FreeRTOS tasks..."));
 
     if (g_sharedContext == nullptr) {
-        Serial.println(F("[ERROR] Shared context not initialized!"));
+        logMessage(LogLevel::ERROR, F("[ERROR] Shared context not initialized!"));
         return false;
     }
 
     // Create the task manager
+#if SEMAPHORE_STATIC_ALLOCATION
+    // Hold the stacks and control blocks of all the tasks
+    static TaskManager taskManager(*g_sharedContext);
+    g_taskManager = &taskManager;
+#else
     g_taskManager = new TaskManager(*g_sharedContext);
+#endif
 
     if (g_taskManager == nullptr) {
-        Serial.println(F("[ERROR] Failed to create task manager!"));
+        logMessage(LogLevel::ERROR, F("[ERROR] Failed to create task manager!"));
         return false;
     }
 
+    // All the intersections are served by the scheduler task
+    if (g_scheduler != nullptr) {
+        g_scheduler->bindContext(*g_sharedContext);
+        g_taskManager->setControlTask(intersectionSchedulerTask<Scheduler::size()>, g_scheduler);
+    }
+
     // Create the tasks
     if (!g_taskManager->createTasks()) {
-        Serial.println(F("[ERROR] Failed to create FreeRTOS tasks!"));
+        logMessage(LogLevel::ERROR, F("[ERROR] Failed to create FreeRTOS tasks!"));
         return false;
     }
 
-    Serial.println(F("[OK] FreeRTOS tasks created successfully"));
+    logMessage(LogLevel::INFO, F("[OK] FreeRTOS tasks created successfully"));
 
     return true;
 }
@@ -208,6 +301,9 @@ bool initializeTasks() {
  * In case of critical error, blink all LEDs
  */
 void fatalError() {
+    // Send the buffered log lines before the fatal messages
+    Logger::flushBlocking();
+
     Serial.println(F("\n[FATAL ERROR] System halted!"));
     Serial.println(F("All LEDs will blink to indicate error state."));
 
@@ -231,6 +327,18 @@ void fatalError() {
             
             delay(250);
         }
+    } else if (g_scheduler != nullptr) {
+        // Multi-intersection mode: blink all LEDs of every signal head
+        const LedConfiguration allOn(LedStatus::ON, LedStatus::ON, LedStatus::ON,
+                                     LedStatus::ON, LedStatus::ON);
+
+        for (;;) {
+            applyToAllIntersections(LedConfiguration());
+            delay(250);
+
+            applyToAllIntersections(allOn);
+            delay(250);
+        }
     } else {
         // if neither hardware was initialized, just stop
         for (;;) {
@@ -254,12 +362,15 @@ void setup() {
         ; // Await until 3 seconds
     }
 
+    // Logger writes directly until the log drain task is created
+    Logger::begin(Serial);
+
     // Print the banner
     printStartupBanner();
     printPinConfiguration();
 
     // Initialization sequence
-    Serial.println(F("\n========== INITIALIZATION SEQUENCE ==========\n"));
+    logMessage(LogLevel::INFO, F("\n========== INITIALIZATION SEQUENCE ==========\n"));
 
     // 1. Initialize hardware
     if (!initializeHardware()) {
@@ -281,15 +392,15 @@ void setup() {
         fatalError();
     }
 
-    Serial.println(F("\n========== INITIALIZATION COMPLETE ==========\n"));
-    Serial.println(F("[INFO] Starting FreeRTOS scheduler..."));
-    Serial.println(F("[INFO] System is now running!\n"));
+    logMessage(LogLevel::INFO, F("\n========== INITIALIZATION COMPLETE ==========\n"));
+    logMessage(LogLevel::INFO, F("[INFO] Starting FreeRTOS scheduler..."));
+    logMessage(LogLevel::INFO, F("[INFO] System is now running!\n"));
 
     // Intialize the scheduler from FreeRTOS
     vTaskStartScheduler();
 
     // If all was wrong, enter in fatal error
-    Serial.println(F("[CRITICAL] Scheduler failed to start!"));
+    logMessage(LogLevel::ERROR, F("[CRITICAL] Scheduler failed to start!"));
     fatalError();
 }
 
@@ -321,6 +432,8 @@ extern "C" void vApplicationStackOverflowHook(TaskHandle_t xTask, char* pcTaskNa
     // Try recover turn off everything
     if (g_hardwareController != nullptr) {
         g_hardwareController->turnAllLedsOff();
+    } else {
+        applyToAllIntersections(LedConfiguration());
     }
 
     // Entry on fatal error
@@ -333,7 +446,7 @@ extern "C" void vApplicationStackOverflowHook(TaskHandle_t xTask, char* pcTaskNa
 extern "C" void vApplicationMallocFailedHook(void) {
     Serial.println(F("[CRITICAL] Memory allocation failed!"));
     Serial.print(F("Free heap: "));
-    Serial.println(xPortGetFreeHeapSize());
+    Serial.println(getFreeHeapSize());
 
     fatalError();
 }
\ No newline at end of file
@@ -1,6 +1,20 @@
 // Included the library to work with servo motors
 #include <Servo.h>
 
+// Included the non-blocking ranging engine (echo timed by interrupts)
+#define ULTRASONIC_RANGER_DEFINE_STATICS
+#include "Shared/Ultrasonic_Ranger.h"
+
+// Included the integer conversions (no float or long division per sample)
+#include "Shared/Fixed_Point.h"
+
+// Included the filter stages (outlier gate, median and EMA)
+#include "Shared/Signal_Filters.h"
+
+// Included the servo trajectory (50 Hz ramps from Timer2, microsecond pulses)
+#define SERVO_MOTION_DEFINE_STATICS
+#include "Shared/Servo_Motion.h"
+
 // Included the pins for the ultrasonic sensor and servo
 const int TRIG_PIN = 12;
 const int ECHO_PIN = 11;
@@ -9,47 +23,73 @@ const int SERVO_PIN = 9;
 // Configs to servo and sensor
 const int MAX_DISTANCE = 200; // Maximum distance for the sensor to detect
 const int MIN_DISTANCE = 2; // Minimum distance for the sensor to detect
-const int SERVO_MIN_ANGLE = 0; // Minimum angle for the servo
-const int SERVO_MAX_ANGLE = 180; // Maximum angle for the servo
+const uint16_t ECHO_TIMEOUT_US = 35000; // Maximum echo time before timeout
+const uint16_t RANGING_PERIOD_MS = 100; // Period between two readings (the servo no longer follows each one)
+
+// Servo pulse range, the limits of the Servo library (0 to 180 degrees)
+const int SERVO_MIN_PULSE_US = ServoMotion::MIN_PULSE_US; // Pulse at MIN_DISTANCE
+const int SERVO_MAX_PULSE_US = ServoMotion::MAX_PULSE_US; // Pulse at MAX_DISTANCE
+const int SERVO_CENTER_PULSE_US = (SERVO_MIN_PULSE_US + SERVO_MAX_PULSE_US) / 2;
+
+// Motion of the servo toward the target (~10 us per degree)
+const uint16_t SERVO_MAX_SPEED = 2000; // Cruise speed (us/s, ~190 degrees/s)
+const uint16_t SERVO_ACCELERATION = 10000; // Acceleration and braking (us/s^2)
+const uint16_t SERVO_DEADBAND_US = 15; // Smaller target changes are ignored (1 cm is ~9 us)
 
 // Filter to stabilize the readings
-const int NUM_READINGS = 5; // Number of readings to average
-long readings[NUM_READINGS]; // Array to store the readings
-int readIndex = 0; // Current index in the readings array
-long total = 0; // Total of the readings
+const int MAX_DISTANCE_STEP = 40; // Maximum change between two readings (cm)
+const int MEDIAN_WINDOW = 5; // Readings in the median (removes bad echoes)
+const int EMA_SHIFT = 2; // Weight of a new reading is 1/4 (removes jitter)
+
+// Out of range and sudden jumps are dropped, then median, then EMA
+SignalFilters::FilterChain<
+    SignalFilters::OutlierGate<MIN_DISTANCE, MAX_DISTANCE, MAX_DISTANCE_STEP>,
+    SignalFilters::MedianFilter<MEDIAN_WINDOW>,
+    SignalFilters::ExponentialFilter<EMA_SHIFT>> distanceFilter;
+int16_t filteredDistance = 0; // Last filtered distance (0 until the first valid reading)
+
+// Distance (cm) to servo pulse (us) with a precomputed slope
+const FixedPoint::LinearMap distanceToPulse(MIN_DISTANCE, MAX_DISTANCE, SERVO_MIN_PULSE_US, SERVO_MAX_PULSE_US);
 
 Servo myServo; // Create a Servo object
+uint8_t rangeSensor = UltrasonicRanger::NO_SENSOR; // Index of the sensor in the ranging engine
 
 void setup(){
 
     Serial.begin(9600); // Start serial communication at 9600 baud rate
     myServo.attach(SERVO_PIN); // Attach the servo to the specified pin
-    pinMode(TRIG_PIN, OUTPUT); // Set the trigger pin as output
-    pinMode(ECHO_PIN, INPUT); // Set the echo pin as input
 
-    // Guarantee the trigger pin is low
-    digitalWrite(TRIG_PIN, LOW);
+    // Register the sensor (trigger as output in LOW, echo as input)
+    rangeSensor = UltrasonicRanger::attach(TRIG_PIN, ECHO_PIN, ECHO_TIMEOUT_US);
 
-    // Initialize the readings array
-    for (int i = 0; i < NUM_READINGS; i++) {
-        readings[i] = 0;
-    }
-    
-    myServo.write(90); // Initialize servo to minimum angle
+    // Initialize servo to the center and start the 50 Hz trajectory steps
+    ServoMotion::begin(myServo, SERVO_CENTER_PULSE_US, SERVO_MAX_SPEED, SERVO_ACCELERATION, SERVO_DEADBAND_US);
     delay(1000); // Wait for the servo to reach the position
 
     Serial.println("Servo and sensor initialized.");
     Serial.println("Waiting the stabilization...");
     delay(2000); // Wait for the sensor to stabilize
+
+    // Start the ranging schedule
+    UltrasonicRanger::begin(RANGING_PERIOD_MS);
 }
 
 void loop(){
-    // Measure the distance with filtering
-    long distance = measureDistanceWithFilter();
+    // Advance the ranging (never blocks)
+    UltrasonicRanger::service();
+
+    // Nothing to do until a new reading arrives
+    if (!UltrasonicRanger::isReady(rangeSensor)) {
+        return;
+    }
+
+    // Convert the echo and filter the distance
+    long rawDistance = echoToDistance(UltrasonicRanger::readEchoMicros(rangeSensor));
+    long distance = measureDistanceWithFilter(rawDistance);
 
     // Detailed debug
     Serial.print("Distância bruta: ");
-    Serial.print(measureDistanceRaw());
+    Serial.print(rawDistance);
     Serial.print(" cm");
     Serial.println("Distância filtrada: ");
     Serial.print(distance);
@@ -57,88 +97,59 @@ void loop(){
 
     // Verify if the distance is valid
     if (distance > 0 && distance <= MAX_DISTANCE) {
-        // Mapping the distance to the servo angle
-        int servoAngle = mapDistanceToAngle(distance);
-
-        // Move the servo to the calculated angle
-        myServo.write(servoAngle);
-
-        Serial.print("Ângulo: ");
-        Serial.print(servoAngle);
-        Serial.print("°");
+        // Mapping the distance to the servo pulse
+        int servoPulse = mapDistanceToPulse(distance);
+
+        // New target of the trajectory (the interrupt ramps the servo to it)
+        bool accepted = ServoMotion::setTarget(servoPulse);
+
+        Serial.print("Pulso: ");
+        Serial.print(servoPulse);
+        Serial.print(" us");
+        if (!accepted) {
+            Serial.print(" (zona morta)");
+        }
     } 
     else {
         Serial.print(" | Leitura inválida - mantendo posição");
     }
-
-    delay(200); // Delay to bigger stabilization
-
 }
 
-long measureDistanceRaw(){
-    // Clean the trigger pin
-    digitalWrite(TRIG_PIN, LOW);
-    delayMicroseconds(5);
-
-    // Send the trigger pulse
-    digitalWrite(TRIG_PIN, HIGH);
-    delayMicroseconds(15);
-    digitalWrite(TRIG_PIN, LOW);
-
-    // Read the echo pulse with 35ms timeout
-    long duration = pulseIn(ECHO_PIN, HIGH, 35000); 
-
-    // If no pulse is received, return 0
+long echoToDistance(uint16_t duration){
+    // If no pulse is received (timeout), return -1
     if (duration == 0) {
        Serial.println("TIMEOUT");
        return -1; // Indicate error
     }
 
-    // Calculate the distance in cm
-    long distance = (duration * 343) / (2 * 10000);
-
-    return distance;
+    // Calculate the distance in cm (multiply and shift)
+    return FixedPoint::echoMicrosToCentimeters(duration);
 }
 
-long measureDistanceWithFilter(){
-    // Subtract the last reading
-    total -= readings[readIndex];
-
-    // Read the distance
-    long distance = measureDistanceRaw();
-    
-    // If there was an error, return the last valid average
-    if (distance <= 0 || distance > MAX_DISTANCE) {
-        distance = readings[readIndex];
+long measureDistanceWithFilter(long distance){
+    // Errors and outliers are dropped, keeping the last filtered distance
+    int16_t output;
+    if (distanceFilter.apply(static_cast<int16_t>(distance), output)) {
+        filteredDistance = output;
     }
 
-    // Store the reading in the array
-    readings[readIndex] = distance;
-
-    // Add the reading to the total
-    total += readings[readIndex];
-
-    // Advance to the next index
-    readIndex = (readIndex + 1) % NUM_READINGS;
-
-    // Return the average
-    return total / NUM_READINGS;
+    return filteredDistance;
 }
 
-int mapDistanceToAngle(long distance){
+int mapDistanceToPulse(long distance){
     // Guarantee the distance is within the sensor limits
     distance = constrain(distance, MIN_DISTANCE, MAX_DISTANCE);
 
-    // Mapping the distance to the servo angle
-    long servoAngle = map(distance, MIN_DISTANCE, MAX_DISTANCE, SERVO_MIN_ANGLE, SERVO_MAX_ANGLE);
+    // Mapping the distance to the servo pulse (without the map() division)
+    int servoPulse = distanceToPulse.apply(distance);
 
     // Mapping the debug
     Serial.print("[Map: ");
     Serial.print(distance);
     Serial.print(" cm");
-    Serial.println(servoAngle);
-    Serial.println("°]");
+    Serial.println(servoPulse);
+    Serial.println(" us]");
 
-    // Guarantee the angle is within the servo limits
-    return constrain(servoAngle, SERVO_MIN_ANGLE, SERVO_MAX_ANGLE);
+    // Guarantee the pulse is within the servo limits
+    return constrain(servoPulse, SERVO_MIN_PULSE_US, SERVO_MAX_PULSE_US);
 }
\ No newline at end of file
@@ -0,0 +1,200 @@
+/**
+ * @file Adc_Oversampler.h
+ * @brief Interrupt-driven ADC sampling with oversampling and decimation
+ * @version 1.0.0
+ *
+ * Replace the blocking analogRead() (~112 us of busy-wait per sample) by:
+ *  - the ADC converting by itself (free-running or on the Timer0 overflow)
+ *  - the conversion complete ISR accumulating 4^n samples
+ *  - the sum decimated to 10 + n bits, handed to the loop without lock
+ *
+ * Each 4x oversampling adds one effective bit, as long as the signal has
+ * at least 1 LSB of noise (the LM35 output and the ADC give it).
+ *
+ *   extraBits  samples  free-running (~9615 Hz)  Timer0 (~977 Hz)
+ *       1          4          2404 results/s        244 results/s
+ *       2         16           601 results/s         61 results/s
+ *       3         64           150 results/s         15 results/s
+ *
+ * The Timer0 trigger reuses the overflow of millis(), so no timer is taken.
+ *
+ * Usage:
+ *   #define ADC_OVERSAMPLER_DEFINE_STATICS   // In one file of the sketch
+ *   AdcOversampler::begin(A0, 3);                 // 13-bit results
+ *   loop: uint16_t value;
+ *         if (AdcOversampler::read(value)) { ... }
+ *
+ * While it runs, the ADC belongs to the oversampler: analogRead() on
+ * another pin would change the channel. Define ADC_OVERSAMPLER_NO_ISR to
+ * write ADC_vect yourself and call AdcOversampler::handleConversion().
+ */
+
+#ifndef ADC_OVERSAMPLER_H
+#define ADC_OVERSAMPLER_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Oversampled readings of one analog channel
+ *
+ * There is one ADC: static engine (see Shared/README.md).
+ */
+class AdcOversampler {
+public:
+    /**
+     * @brief Start of each conversion
+     */
+    enum class Trigger : uint8_t {
+        FREE_RUNNING,   // Next conversion as soon as one ends (13 ADC clocks)
+        TIMER0_OVERFLOW // One conversion per millis() tick (~1024 us)
+    };
+
+    static constexpr uint8_t MAX_EXTRA_BITS = 3; // 64 samples: 64 * 1023 fits 16 bits
+
+private:
+    // ADC clock = F_CPU / 128 = 125 kHz at 16 MHz (the 50-200 kHz range of full accuracy)
+    static constexpr uint8_t PRESCALER_BITS = _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
+    static constexpr uint8_t TRIGGER_TIMER0_OVERFLOW = _BV(ADTS2);
+
+    static uint16_t accumulator_;       // Only used by the ISR
+    static uint8_t samples_;            // Only used by the ISR
+    static uint8_t samplesPerResult_;
+    static uint8_t extraBits_;
+    static volatile uint16_t result_;
+    static volatile uint8_t sequence_;  // Incremented after each result
+    static uint8_t lastRead_;           // Sequence of the last read() result
+
+public:
+    /**
+     * @brief Start the conversions on an analog pin
+     * @param pin Analog pin (A0...) or channel number (0...)
+     * @param extraBits Effective bits added (0 to MAX_EXTRA_BITS): 4^extraBits samples per result
+     * @param trigger Start of each conversion
+     */
+    static void begin(uint8_t pin, uint8_t extraBits, Trigger trigger = Trigger::FREE_RUNNING) {
+        uint8_t channel = pin >= A0 ? pin - A0 : pin;
+
+        extraBits_ = extraBits > MAX_EXTRA_BITS ? MAX_EXTRA_BITS : extraBits;
+        samplesPerResult_ = 1 << (2 * extraBits_);
+
+        const uint8_t oldSREG = SREG;
+        cli();
+
+        ADCSRA = 0; // Stop a conversion in progress
+        accumulator_ = 0;
+        samples_ = 0;
+        sequence_ = 0;
+        lastRead_ = 0;
+
+        // AVcc reference (like analogRead), right adjusted
+        ADMUX = _BV(REFS0) | (channel & 0x07);
+
+#if defined(MUX5)
+        // Channels 8-15 of the Mega
+        ADCSRB = (channel & 0x08) ? _BV(MUX5) : 0;
+#else
+        ADCSRB = 0;
+#endif
+
+        if (trigger == Trigger::TIMER0_OVERFLOW) {
+            ADCSRB |= TRIGGER_TIMER0_OVERFLOW;
+        }
+
+        // Enable, auto trigger, interrupt, and start the first conversion
+        ADCSRA = _BV(ADEN) | _BV(ADSC) | _BV(ADATE) | _BV(ADIE) | PRESCALER_BITS;
+
+        SREG = oldSREG;
+    }
+
+    /**
+     * @brief Stop the conversions (analogRead() can be used again)
+     */
+    static void end() {
+        ADCSRA = _BV(ADEN) | PRESCALER_BITS;
+    }
+
+    /**
+     * @brief Effective bits of the results (10 + extraBits)
+     */
+    static uint8_t getResolutionBits() {
+        return 10 + extraBits_;
+    }
+
+    /**
+     * @brief Extra bits of the results (for the conversion functions)
+     */
+    static uint8_t getExtraBits() {
+        return extraBits_;
+    }
+
+    /**
+     * @brief Last result, new or not
+     * Without lock: the read is repeated if a result arrived in the middle
+     */
+    static uint16_t latest() {
+        uint8_t sequence;
+        uint16_t value;
+
+        do {
+            sequence = sequence_;
+            value = result_;
+        } while (sequence != sequence_);
+
+        return value;
+    }
+
+    /**
+     * @brief Read the last result if it was not read yet
+     * @return false if no new result since the last call
+     *         (or exactly 256 results since it, the sequence is 8 bits)
+     */
+    static bool read(uint16_t& value) {
+        uint8_t sequence;
+
+        do {
+            sequence = sequence_;
+            value = result_;
+        } while (sequence != sequence_);
+
+        if (sequence == lastRead_) {
+            return false;
+        }
+
+        lastRead_ = sequence;
+        return true;
+    }
+
+    /**
+     * @brief Conversion complete handler (called by ADC_vect)
+     */
+    static void handleConversion() {
+        accumulator_ += ADC;
+
+        if (++samples_ < samplesPerResult_) {
+            return;
+        }
+
+        // Decimation: 4^n samples summed, divided by 2^n
+        result_ = accumulator_ >> extraBits_;
+        sequence_ = sequence_ + 1;
+
+        accumulator_ = 0;
+        samples_ = 0;
+    }
+};
+
+#ifdef ADC_OVERSAMPLER_DEFINE_STATICS
+uint16_t AdcOversampler::accumulator_ = 0;
+uint8_t AdcOversampler::samples_ = 0;
+uint8_t AdcOversampler::samplesPerResult_ = 1;
+uint8_t AdcOversampler::extraBits_ = 0;
+volatile uint16_t AdcOversampler::result_ = 0;
+volatile uint8_t AdcOversampler::sequence_ = 0;
+uint8_t AdcOversampler::lastRead_ = 0;
+
+#ifndef ADC_OVERSAMPLER_NO_ISR
+ISR(ADC_vect) { AdcOversampler::handleConversion(); }
+#endif
+#endif // ADC_OVERSAMPLER_DEFINE_STATICS
+
+#endif // ADC_OVERSAMPLER_H
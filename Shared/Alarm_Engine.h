@@ -0,0 +1,330 @@
+/**
+ * @file Alarm_Engine.h
+ * @brief Alarms with hysteresis and dwell time, buzzer and LED patterns on Timer2
+ * @version 1.0.0
+ *
+ * HysteresisAlarm: the state changes only when the value passes the set
+ * threshold (or back the clear threshold) during at least the dwell time,
+ * so a reading oscillating around one threshold doesn't flip the alarm.
+ *
+ * AlarmSignal: the Timer2 compare ISR generates the buzzer square wave and
+ * steps the patterns (16 steps per cycle), replacing tone() and delay():
+ *  - buzzer and LED on/off per step (beep cadence, blink)
+ *  - escalation: a pattern is played some cycles, then the next level
+ *
+ * Usage:
+ *   #define ALARM_ENGINE_DEFINE_STATICS   // In one file of the sketch
+ *   HysteresisAlarm highTemp(4000, 3900, 2000);   // Set 40 C, clear 39 C, 2 s
+ *   AlarmSignal::begin(BUZZER_PIN, LED_PIN, 1000); // 1 kHz tone
+ *   loop: if (highTemp.update(value)) {
+ *             highTemp.isActive() ? AlarmSignal::play(LEVELS, 3) : AlarmSignal::stop();
+ *         }
+ *
+ * Timer2 is also used by tone() (and PWM on pins 3/11 of the Uno): don't
+ * mix them. Define ALARM_ENGINE_NO_ISR to write TIMER2_COMPA_vect yourself
+ * and call AlarmSignal::handleTick().
+ */
+
+#ifndef ALARM_ENGINE_H
+#define ALARM_ENGINE_H
+
+#include <Arduino.h>
+
+// ==================== HYSTERESIS ====================
+
+/**
+ * @brief Two-threshold alarm with a minimum dwell time
+ */
+class HysteresisAlarm {
+public:
+    /**
+     * @brief Side of the set threshold that is an alarm
+     */
+    enum class Direction : uint8_t {
+        ABOVE, // Active at value >= set, cleared at value <= clear (clear < set)
+        BELOW  // Active at value <= set, cleared at value >= clear (clear > set)
+    };
+
+private:
+    int16_t setThreshold_;
+    int16_t clearThreshold_;
+    uint16_t dwellMs_;
+    Direction direction_;
+    bool active_;
+    bool changing_;      // Condition of the other state seen, waiting the dwell
+    uint32_t changeStartMs_;
+
+    bool reachedSet(int16_t value) const {
+        return direction_ == Direction::ABOVE ? value >= setThreshold_ : value <= setThreshold_;
+    }
+
+    bool reachedClear(int16_t value) const {
+        return direction_ == Direction::ABOVE ? value <= clearThreshold_ : value >= clearThreshold_;
+    }
+
+public:
+    HysteresisAlarm(int16_t setThreshold, int16_t clearThreshold, uint16_t dwellMs,
+                    Direction direction = Direction::ABOVE)
+        : setThreshold_(setThreshold),
+          clearThreshold_(clearThreshold),
+          dwellMs_(dwellMs),
+          direction_(direction),
+          active_(false),
+          changing_(false),
+          changeStartMs_(0) {}
+
+    /**
+     * @brief Evaluate a new value
+     * @return true if the alarm state changed (active or cleared)
+     */
+    bool update(int16_t value, uint32_t nowMs = millis()) {
+        const bool toggle = active_ ? reachedClear(value) : reachedSet(value);
+
+        if (!toggle) {
+            changing_ = false;
+            return false;
+        }
+
+        if (!changing_) {
+            changing_ = true;
+            changeStartMs_ = nowMs;
+        }
+
+        if (nowMs - changeStartMs_ < dwellMs_) {
+            return false;
+        }
+
+        active_ = !active_;
+        changing_ = false;
+        return true;
+    }
+
+    bool isActive() const {
+        return active_;
+    }
+
+    /**
+     * @brief Force the state (e.g. system off)
+     */
+    void reset(bool active = false) {
+        active_ = active;
+        changing_ = false;
+    }
+};
+
+// ==================== SIGNAL ====================
+
+/**
+ * @brief One level of an alarm signal: 16 steps of stepMs
+ * Bit i of a mask (LSB first) is the output during the step i
+ */
+struct AlarmPattern {
+    uint16_t buzzerSteps;
+    uint16_t ledSteps;
+    uint8_t stepMs;
+    uint8_t cycles;      // Cycles before the next level (0 = forever)
+};
+
+/**
+ * @brief Buzzer and LED driven by the Timer2 compare interrupt
+ *
+ * There is one Timer2: static engine (see Shared/README.md).
+ */
+class AlarmSignal {
+public:
+    static constexpr uint8_t NO_PIN = 0xFF;
+    static constexpr uint8_t STEPS_PER_CYCLE = 16;
+
+private:
+    static volatile uint8_t* buzzerPort_;
+    static uint8_t buzzerMask_;
+    static volatile uint8_t* ledPort_;
+    static uint8_t ledMask_;
+    static uint8_t ticksPerMs_;
+
+    // Shared with the ISR (written with interrupts disabled)
+    static const AlarmPattern* volatile levels_;
+    static uint8_t levelCount_;
+    static uint8_t level_;
+    static uint8_t step_;
+    static uint8_t cycle_;
+    static uint16_t ticks_;
+    static uint16_t ticksPerStep_;
+
+    static void configurePin(uint8_t pin, volatile uint8_t*& port, uint8_t& mask) {
+        if (pin == NO_PIN) {
+            port = nullptr;
+            mask = 0;
+            return;
+        }
+
+        pinMode(pin, OUTPUT);
+        digitalWrite(pin, LOW);
+        port = portOutputRegister(digitalPinToPort(pin));
+        mask = digitalPinToBitMask(pin);
+    }
+
+    static void write(volatile uint8_t* port, uint8_t mask, bool on) {
+        if (port == nullptr) {
+            return;
+        }
+
+        if (on) {
+            *port |= mask;
+        } else {
+            *port &= ~mask;
+        }
+    }
+
+    // Outputs of the current step (called with interrupts disabled)
+    static void applyStep() {
+        const AlarmPattern& pattern = levels_[level_];
+        const uint16_t bit = 1U << step_;
+
+        write(ledPort_, ledMask_, (pattern.ledSteps & bit) != 0);
+        if ((pattern.buzzerSteps & bit) == 0) {
+            write(buzzerPort_, buzzerMask_, false);
+        }
+    }
+
+    static void startLevel(uint8_t level) {
+        level_ = level;
+        step_ = 0;
+        cycle_ = 0;
+        ticks_ = 0;
+        ticksPerStep_ = static_cast<uint16_t>(levels_[level].stepMs) * ticksPerMs_;
+        applyStep();
+    }
+
+public:
+    /**
+     * @brief Configure the pins and start Timer2 at twice the tone frequency
+     * @param buzzerPin Passive buzzer pin (or NO_PIN)
+     * @param ledPin LED pin (or NO_PIN)
+     * @param toneHz Buzzer frequency, 500 to 4000 Hz (step times are
+     *        exact for multiples of 500 Hz)
+     */
+    static void begin(uint8_t buzzerPin, uint8_t ledPin, uint16_t toneHz = 1000) {
+        configurePin(buzzerPin, buzzerPort_, buzzerMask_);
+        configurePin(ledPin, ledPort_, ledMask_);
+
+        const uint32_t tickHz = 2UL * toneHz; // Two edges per period
+        ticksPerMs_ = static_cast<uint8_t>((tickHz + 500) / 1000);
+
+        // Smallest prescaler with the period in the 8-bit counter
+        static const uint16_t PRESCALERS[] = {1, 8, 32, 64, 128, 256, 1024};
+        uint8_t select = 0;
+        uint32_t counts = F_CPU / tickHz;
+        while (select < 6 && counts / PRESCALERS[select] > 256) {
+            select++;
+        }
+        counts /= PRESCALERS[select];
+
+        const uint8_t oldSREG = SREG;
+        cli();
+
+        levels_ = nullptr;
+        TCCR2A = _BV(WGM21);        // CTC, TOP = OCR2A
+        TCCR2B = select + 1;        // CS22:0 = 1...7 in the PRESCALERS order
+        OCR2A = static_cast<uint8_t>(counts - 1);
+        TCNT2 = 0;
+        TIMSK2 = _BV(OCIE2A);
+
+        SREG = oldSREG;
+    }
+
+    /**
+     * @brief Play the levels of a signal, from the first one
+     * Playing the signal already in progress does nothing (no restart)
+     * @param levels Array of levels (must stay valid while playing)
+     * @param count Number of levels; the last is played until stop()
+     */
+    static void play(const AlarmPattern* levels, uint8_t count) {
+        if (levels == nullptr || count == 0 || levels == levels_) {
+            return;
+        }
+
+        const uint8_t oldSREG = SREG;
+        cli();
+        levels_ = levels;
+        levelCount_ = count;
+        startLevel(0);
+        SREG = oldSREG;
+    }
+
+    /**
+     * @brief Stop the signal: buzzer and LED off
+     */
+    static void stop() {
+        const uint8_t oldSREG = SREG;
+        cli();
+        levels_ = nullptr;
+        write(buzzerPort_, buzzerMask_, false);
+        write(ledPort_, ledMask_, false);
+        SREG = oldSREG;
+    }
+
+    static bool isPlaying() {
+        return levels_ != nullptr;
+    }
+
+    /**
+     * @brief Current level of the signal (escalation)
+     */
+    static uint8_t getLevel() {
+        return level_;
+    }
+
+    /**
+     * @brief Timer2 compare handler (called by TIMER2_COMPA_vect)
+     */
+    static void handleTick() {
+        const AlarmPattern* levels = levels_;
+        if (levels == nullptr) {
+            return;
+        }
+
+        // Square wave while the buzzer is on in this step
+        if (buzzerPort_ != nullptr && (levels[level_].buzzerSteps & (1U << step_)) != 0) {
+            *buzzerPort_ ^= buzzerMask_;
+        }
+
+        if (++ticks_ < ticksPerStep_) {
+            return;
+        }
+        ticks_ = 0;
+
+        if (++step_ >= STEPS_PER_CYCLE) {
+            step_ = 0;
+
+            const AlarmPattern& pattern = levels[level_];
+            if (pattern.cycles != 0 && ++cycle_ >= pattern.cycles && level_ + 1 < levelCount_) {
+                startLevel(level_ + 1); // Escalation
+                return;
+            }
+        }
+
+        applyStep();
+    }
+};
+
+#ifdef ALARM_ENGINE_DEFINE_STATICS
+volatile uint8_t* AlarmSignal::buzzerPort_ = nullptr;
+uint8_t AlarmSignal::buzzerMask_ = 0;
+volatile uint8_t* AlarmSignal::ledPort_ = nullptr;
+uint8_t AlarmSignal::ledMask_ = 0;
+uint8_t AlarmSignal::ticksPerMs_ = 2;
+const AlarmPattern* volatile AlarmSignal::levels_ = nullptr;
+uint8_t AlarmSignal::levelCount_ = 0;
+uint8_t AlarmSignal::level_ = 0;
+uint8_t AlarmSignal::step_ = 0;
+uint8_t AlarmSignal::cycle_ = 0;
+uint16_t AlarmSignal::ticks_ = 0;
+uint16_t AlarmSignal::ticksPerStep_ = 0;
+
+#ifndef ALARM_ENGINE_NO_ISR
+ISR(TIMER2_COMPA_vect) { AlarmSignal::handleTick(); }
+#endif
+#endif // ALARM_ENGINE_DEFINE_STATICS
+
+#endif // ALARM_ENGINE_H
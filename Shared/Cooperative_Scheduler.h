@@ -0,0 +1,259 @@
+/**
+ * @file Cooperative_Scheduler.h
+ * @brief Run-to-completion jobs with periods, deadlines, overrun counters and idle sleep
+ * @version 1.0.0
+ *
+ * Replace the delay() based loops (CPU busy waiting, inputs ignored while
+ * waiting) by jobs called from one loop:
+ *  - periodic jobs: released every period, without drift (the next release
+ *    is the previous one plus the period, not "now" plus the period)
+ *  - polled jobs (period 0): called on each pass, for the service()
+ *    functions of the background engines and quick input checks
+ *  - a deadline per job, relative to its release: a job ending after it
+ *    counts an overrun; releases missed by a long job are skipped (counted,
+ *    no burst of late runs)
+ *  - trigger(): run a job on the next pass (e.g. redraw on a key press)
+ *  - idle(): sleep in IDLE mode when no periodic job is due; any interrupt
+ *    wakes the CPU (Timer0 every 1.024 ms, so millis() keeps counting)
+ *
+ * Jobs run to completion, one at a time: they must not block.
+ *
+ * Usage:
+ *   CooperativeScheduler<4> scheduler;
+ *   setup: scheduler.addPeriodic(updateDisplay, 500);
+ *          scheduler.addPolled(readInputs);
+ *   loop:  scheduler.run(); scheduler.idle();
+ */
+
+#ifndef COOPERATIVE_SCHEDULER_H
+#define COOPERATIVE_SCHEDULER_H
+
+#include <Arduino.h>
+#include <avr/sleep.h>
+
+/**
+ * @brief Job table of a sketch
+ * @tparam MAX_JOBS Number of jobs
+ */
+template <uint8_t MAX_JOBS>
+class CooperativeScheduler {
+public:
+    using JobFunction = void (*)();
+
+    static constexpr uint8_t INVALID_JOB = 0xFF;
+
+private:
+    static_assert(MAX_JOBS > 0 && MAX_JOBS < INVALID_JOB, "CooperativeScheduler: 1 to 254 jobs");
+
+    struct Job {
+        JobFunction function;
+        uint32_t release;      // Next release (millis)
+        uint16_t period;       // 0 = polled
+        uint16_t deadline;     // From the release (ms)
+        uint16_t overruns;
+        uint16_t maxRunMicros;
+        bool enabled;
+        bool triggered;
+    };
+
+    Job jobs_[MAX_JOBS];
+    uint8_t count_;
+
+    static void countOverrun(Job& job, uint16_t overruns) {
+        job.overruns = (job.overruns > 0xFFFF - overruns) ? 0xFFFF : job.overruns + overruns;
+    }
+
+    uint8_t add(JobFunction function, uint16_t periodMs, uint16_t deadlineMs, uint16_t offsetMs) {
+        if (count_ >= MAX_JOBS || function == nullptr) {
+            return INVALID_JOB;
+        }
+
+        Job& job = jobs_[count_];
+        job.function = function;
+        job.release = millis() + offsetMs;
+        job.period = periodMs;
+        job.deadline = (deadlineMs == 0) ? periodMs : deadlineMs;
+        job.overruns = 0;
+        job.maxRunMicros = 0;
+        job.enabled = true;
+        job.triggered = false;
+        return count_++;
+    }
+
+    void execute(Job& job) {
+        const uint32_t start = micros();
+        job.function();
+        const uint32_t elapsed = micros() - start;
+        const uint16_t saturated = elapsed > 0xFFFF ? 0xFFFF : static_cast<uint16_t>(elapsed);
+
+        if (saturated > job.maxRunMicros) {
+            job.maxRunMicros = saturated;
+        }
+    }
+
+    /**
+     * @brief true if a periodic (or triggered) job is due now
+     */
+    bool isDue(uint32_t now) const {
+        for (uint8_t i = 0; i < count_; i++) {
+            const Job& job = jobs_[i];
+            if (!job.enabled) {
+                continue;
+            }
+            if (job.triggered || (job.period != 0 && static_cast<int32_t>(now - job.release) >= 0)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+public:
+    CooperativeScheduler() : jobs_(), count_(0) {}
+
+    /**
+     * @brief Job released every periodMs
+     * @param deadlineMs Maximum time from the release to the end (0 = the period)
+     * @param offsetMs First release after offsetMs (spread jobs of the same period)
+     * @return Job index, INVALID_JOB if the table is full
+     */
+    uint8_t addPeriodic(JobFunction function, uint16_t periodMs, uint16_t deadlineMs = 0, uint16_t offsetMs = 0) {
+        if (periodMs == 0) {
+            return INVALID_JOB;
+        }
+        return add(function, periodMs, deadlineMs, offsetMs);
+    }
+
+    /**
+     * @brief Job called on each pass (must be short)
+     * @return Job index, INVALID_JOB if the table is full
+     */
+    uint8_t addPolled(JobFunction function) {
+        return add(function, 0, 0, 0);
+    }
+
+    /**
+     * @brief Enable or disable a job; enabling releases it again from now
+     */
+    void setEnabled(uint8_t job, bool enabled) {
+        if (job >= count_) {
+            return;
+        }
+        if (enabled && !jobs_[job].enabled) {
+            jobs_[job].release = millis();
+        }
+        jobs_[job].enabled = enabled;
+    }
+
+    /**
+     * @brief Run a job on the next pass (its periodic releases are kept)
+     */
+    void trigger(uint8_t job) {
+        if (job < count_) {
+            jobs_[job].triggered = true;
+        }
+    }
+
+    /**
+     * @brief One pass: the polled jobs, the triggered ones and the ones released
+     */
+    void run() {
+        for (uint8_t i = 0; i < count_; i++) {
+            Job& job = jobs_[i];
+            if (!job.enabled) {
+                continue;
+            }
+
+            if (job.period == 0) {
+                execute(job);
+                continue;
+            }
+
+            const uint32_t now = millis();
+            const bool released = static_cast<int32_t>(now - job.release) >= 0;
+            if (!released && !job.triggered) {
+                continue;
+            }
+
+            job.triggered = false;
+            execute(job);
+
+            if (!released) {
+                continue; // Triggered only: the periodic schedule is unchanged
+            }
+
+            // Deadline from the release; releases already passed are skipped
+            const uint32_t end = millis();
+            if (end - job.release > job.deadline) {
+                countOverrun(job, 1);
+            }
+
+            const uint32_t late = end - job.release;
+            const uint32_t periods = late / job.period + 1;
+            if (periods > 1) {
+                countOverrun(job, periods - 1);
+            }
+            job.release += periods * job.period;
+        }
+    }
+
+    /**
+     * @brief Sleep (IDLE mode) until the next interrupt if no job is due
+     * The Timer0 interrupt wakes the CPU every 1.024 ms, so a release is
+     * late by at most ~1 ms (also a flag set by an interrupt between the
+     * check and the sleep); the other peripherals keep running
+     */
+    void idle() {
+        if (isDue(millis())) {
+            return;
+        }
+
+        set_sleep_mode(SLEEP_MODE_IDLE);
+        sleep_enable();
+        sleep_cpu();
+        sleep_disable();
+    }
+
+    /**
+     * @brief Time until the next periodic release (0 if one is due)
+     */
+    uint32_t getMillisToNextRelease() const {
+        const uint32_t now = millis();
+        uint32_t next = 0xFFFFFFFFUL;
+
+        for (uint8_t i = 0; i < count_; i++) {
+            const Job& job = jobs_[i];
+            if (!job.enabled || job.period == 0) {
+                continue;
+            }
+
+            const int32_t remaining = static_cast<int32_t>(job.release - now);
+            if (remaining <= 0 || job.triggered) {
+                return 0;
+            }
+            if (static_cast<uint32_t>(remaining) < next) {
+                next = remaining;
+            }
+        }
+        return next;
+    }
+
+    /**
+     * @brief Deadlines missed plus releases skipped since the start
+     */
+    uint16_t getOverruns(uint8_t job) const {
+        return job < count_ ? jobs_[job].overruns : 0;
+    }
+
+    /**
+     * @brief Longest run of the job (us, saturated)
+     */
+    uint16_t getMaxRunMicros(uint8_t job) const {
+        return job < count_ ? jobs_[job].maxRunMicros : 0;
+    }
+
+    uint8_t getJobCount() const {
+        return count_;
+    }
+};
+
+#endif // COOPERATIVE_SCHEDULER_H
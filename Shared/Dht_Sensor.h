@@ -0,0 +1,229 @@
+/**
+ * @file Dht_Sensor.h
+ * @brief Background DHT22 (AM2302) acquisition with a cached last good value
+ * @version 1.0.0
+ *
+ * Replace the DHT library reads (~5 ms bit-banged with interrupts off on
+ * each call) by:
+ *  - a 1.1 ms start pulse fired from service(), at most every 2 s
+ *  - the 40 data bits decoded in the external interrupt (falling edges
+ *    timestamped with micros(): ~78 us apart for a 0, ~120 us for a 1)
+ *  - the last good reading cached with its age; a failed or corrupted
+ *    reading keeps the cached value
+ *
+ * Values are integers: temperature in tenths of degree Celsius, humidity
+ * in tenths of percent (the sensor resolution, no float).
+ *
+ * Usage:
+ *   #define DHT_SENSOR_DEFINE_STATICS   // In one file of the sketch
+ *   DhtSensor::begin(2);                 // Pin with external interrupt (2 or 3 on the Uno)
+ *   loop: DhtSensor::service();          // Never blocks (besides the start pulse)
+ *         if (DhtSensor::hasValue()) { ... getTemperatureDeci() ... }
+ */
+
+#ifndef DHT_SENSOR_H
+#define DHT_SENSOR_H
+
+#include <Arduino.h>
+
+/**
+ * @brief One DHT22 on an external interrupt pin
+ *
+ * Static engine, driven by the external interrupt (see Shared/README.md).
+ */
+class DhtSensor {
+public:
+    // Datasheet: at least 2 s between two readings
+    static constexpr uint16_t MIN_PERIOD_MS = 2000;
+
+private:
+    static constexpr uint8_t DATA_BITS = 40;
+    static constexpr uint8_t TOTAL_EDGES = DATA_BITS + 2;  // Response low + response high + bits
+    static constexpr uint16_t START_PULSE_US = 1100;       // Host low pulse (>= 1 ms)
+    static constexpr uint16_t BIT_ONE_US = 100;            // Edge interval above = bit 1
+    static constexpr uint16_t READ_TIMEOUT_US = 10000;     // Whole frame is ~5 ms
+
+    static uint8_t pin_;
+    static uint16_t periodMillis_;
+    static uint32_t lastStartMillis_;
+    static uint32_t startMicros_;
+
+    // Frame in progress (shared with the ISR)
+    static volatile bool reading_;
+    static volatile uint8_t edges_;
+    static volatile uint32_t lastEdgeMicros_;
+    static volatile uint8_t data_[DATA_BITS / 8];
+
+    // Cache
+    static int16_t temperatureDeci_;
+    static uint16_t humidityDeci_;
+    static uint32_t lastGoodMillis_;
+    static bool hasValue_;
+    static uint8_t failures_;
+
+    static void startReading() {
+        // Start signal: host holds the line low, then releases it
+        pinMode(pin_, OUTPUT);
+        digitalWrite(pin_, LOW);
+        delayMicroseconds(START_PULSE_US);
+
+        const uint8_t oldSREG = SREG;
+        cli();
+        edges_ = 0;
+        for (uint8_t i = 0; i < sizeof(data_); i++) {
+            data_[i] = 0;
+        }
+        reading_ = true;
+        pinMode(pin_, INPUT_PULLUP);
+        SREG = oldSREG;
+
+        startMicros_ = micros();
+        lastStartMillis_ = millis();
+    }
+
+    static void countFailure() {
+        if (failures_ < 0xFF) {
+            failures_++;
+        }
+    }
+
+    static void decode() {
+        const uint8_t checksum = data_[0] + data_[1] + data_[2] + data_[3];
+        const uint16_t humidity = (static_cast<uint16_t>(data_[0]) << 8) | data_[1];
+        const uint16_t magnitude = (static_cast<uint16_t>(data_[2] & 0x7F) << 8) | data_[3];
+
+        if (checksum != data_[4] || humidity > 1000) {
+            countFailure();
+            return;
+        }
+
+        humidityDeci_ = humidity;
+        temperatureDeci_ = (data_[2] & 0x80) ? -static_cast<int16_t>(magnitude) : static_cast<int16_t>(magnitude);
+        lastGoodMillis_ = millis();
+        hasValue_ = true;
+        failures_ = 0;
+    }
+
+public:
+    /**
+     * @brief Attach the sensor and start the readings
+     * @param periodMs Period between two readings (raised to MIN_PERIOD_MS)
+     * @return false if the pin has no external interrupt
+     */
+    static bool begin(uint8_t pin, uint16_t periodMs = MIN_PERIOD_MS) {
+        const int interrupt = digitalPinToInterrupt(pin);
+        if (interrupt == NOT_AN_INTERRUPT) {
+            return false;
+        }
+
+        pin_ = pin;
+        periodMillis_ = periodMs < MIN_PERIOD_MS ? MIN_PERIOD_MS : periodMs;
+        pinMode(pin_, INPUT_PULLUP);
+
+        attachInterrupt(interrupt, handleEdge, FALLING);
+
+        // First reading after the power-up time of the sensor (~1 s after begin)
+        lastStartMillis_ = millis() - periodMillis_ + 1000;
+        return true;
+    }
+
+    /**
+     * @brief Advance the acquisition: finish a frame, start the next one
+     * Must be called often from the loop
+     */
+    static void service() {
+        if (reading_) {
+            if (edges_ >= TOTAL_EDGES) {
+                reading_ = false;
+                decode();
+            } else if (micros() - startMicros_ > READ_TIMEOUT_US) {
+                reading_ = false; // No answer or bits lost: keep the cached value
+                countFailure();
+            }
+            return;
+        }
+
+        if (millis() - lastStartMillis_ >= periodMillis_) {
+            startReading();
+        }
+    }
+
+    /**
+     * @brief At least one good reading since begin
+     */
+    static bool hasValue() {
+        return hasValue_;
+    }
+
+    /**
+     * @brief Last good temperature, tenths of degree Celsius
+     */
+    static int16_t getTemperatureDeci() {
+        return temperatureDeci_;
+    }
+
+    /**
+     * @brief Last good relative humidity, tenths of percent
+     */
+    static uint16_t getHumidityDeci() {
+        return humidityDeci_;
+    }
+
+    /**
+     * @brief Time since the last good reading
+     */
+    static uint32_t getAgeMillis() {
+        return millis() - lastGoodMillis_;
+    }
+
+    /**
+     * @brief Consecutive failed readings (0 after a good one)
+     */
+    static uint8_t getFailures() {
+        return failures_;
+    }
+
+    /**
+     * @brief Falling edge handler (attached to the external interrupt)
+     */
+    static void handleEdge() {
+        if (!reading_) {
+            return; // Start pulse of the host, or frame already complete
+        }
+
+        const uint8_t edge = edges_;
+        if (edge >= TOTAL_EDGES) {
+            return;
+        }
+
+        const uint32_t now = micros();
+
+        // Edges 0 and 1 are the response; each next one ends a bit
+        if (edge >= 2) {
+            const uint8_t bitIndex = edge - 2;
+            const uint8_t bit = (now - lastEdgeMicros_) > BIT_ONE_US ? 1 : 0;
+            data_[bitIndex >> 3] = (data_[bitIndex >> 3] << 1) | bit;
+        }
+
+        lastEdgeMicros_ = now;
+        edges_ = edge + 1;
+    }
+};
+
+#ifdef DHT_SENSOR_DEFINE_STATICS
+uint8_t DhtSensor::pin_ = 0;
+uint16_t DhtSensor::periodMillis_ = DhtSensor::MIN_PERIOD_MS;
+uint32_t DhtSensor::lastStartMillis_ = 0;
+uint32_t DhtSensor::startMicros_ = 0;
+volatile bool DhtSensor::reading_ = false;
+volatile uint8_t DhtSensor::edges_ = 0;
+volatile uint32_t DhtSensor::lastEdgeMicros_ = 0;
+volatile uint8_t DhtSensor::data_[DhtSensor::DATA_BITS / 8];
+int16_t DhtSensor::temperatureDeci_ = 0;
+uint16_t DhtSensor::humidityDeci_ = 0;
+uint32_t DhtSensor::lastGoodMillis_ = 0;
+bool DhtSensor::hasValue_ = false;
+uint8_t DhtSensor::failures_ = 0;
+#endif // DHT_SENSOR_DEFINE_STATICS
+
+#endif // DHT_SENSOR_H
@@ -0,0 +1,170 @@
+/**
+ * @file Event_Dispatcher.h
+ * @brief Allocation-free publish/subscribe queue with O(1) dispatch per event type
+ * @version 1.0.0
+ *
+ * - Subscribers indexed by event type: process() calls only the
+ *   callbacks of the event type, without scanning a table
+ * - Power of two queue: free-running 8-bit indices, wrap is a mask
+ * - Events copied in the queue (payload inline in the sketch's Event)
+ * - Coalescing of "state" event types (at most one pending)
+ * - Capacity errors: template parameters checked at compile time,
+ *   subscribe() returns false when a type is full (and counts it)
+ *
+ * The sketch defines the event, with a `type` member of an enum class:
+ *   enum class EventType : uint8_t { INIT, TOUCH, IDLE, COUNT };
+ *   struct Event { EventType type; union { TouchPayload touch; }; };
+ *   EventDispatcher<Event, static_cast<uint8_t>(EventType::COUNT), 2, 16> dispatcher;
+ *
+ * publish() and process() must be called from the loop (not from an ISR).
+ */
+
+#ifndef EVENT_DISPATCHER_H
+#define EVENT_DISPATCHER_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Queue and subscriber table of a sketch
+ * @tparam Event Event structure, with a `type` member (enum, 0 to EVENT_TYPES - 1)
+ * @tparam EVENT_TYPES Number of event types
+ * @tparam MAX_PER_TYPE Subscribers per event type
+ * @tparam QUEUE_SIZE Pending events (power of two)
+ */
+template <typename Event, uint8_t EVENT_TYPES, uint8_t MAX_PER_TYPE, uint8_t QUEUE_SIZE>
+class EventDispatcher {
+public:
+    using EventCallback = void (*)(const Event&);
+
+private:
+    static_assert(EVENT_TYPES > 0 && EVENT_TYPES <= 16, "EventDispatcher: 1 to 16 event types (16-bit masks)");
+    static_assert(MAX_PER_TYPE > 0, "EventDispatcher: at least one subscriber per type");
+    static_assert(QUEUE_SIZE > 0 && QUEUE_SIZE <= 128 && (QUEUE_SIZE & (QUEUE_SIZE - 1)) == 0,
+                  "EventDispatcher: QUEUE_SIZE must be a power of two up to 128");
+
+    static constexpr uint8_t QUEUE_MASK = QUEUE_SIZE - 1;
+
+    EventCallback subscribers_[EVENT_TYPES][MAX_PER_TYPE];
+    uint8_t subscriberCount_[EVENT_TYPES];
+    Event queue_[QUEUE_SIZE];
+    uint8_t head_;               // Free-running: index = head_ & QUEUE_MASK
+    uint8_t tail_;
+    uint16_t coalescingMask_;
+    uint16_t pendingMask_;       // Coalescing types with an event in the queue
+    uint16_t dropped_[EVENT_TYPES];
+    uint16_t coalesced_[EVENT_TYPES];
+    uint8_t rejectedSubscriptions_;
+
+    static uint8_t indexOf(const Event& event) {
+        return static_cast<uint8_t>(event.type);
+    }
+
+public:
+    EventDispatcher()
+        : subscribers_(), subscriberCount_(), head_(0), tail_(0),
+          coalescingMask_(0), pendingMask_(0), dropped_(), coalesced_(),
+          rejectedSubscriptions_(0) {}
+
+    /**
+     * @brief Register a callback for an event type
+     * @return false if the type already has MAX_PER_TYPE subscribers
+     */
+    template <typename Type>
+    bool subscribe(Type type, EventCallback callback) {
+        const uint8_t index = static_cast<uint8_t>(type);
+
+        if (index >= EVENT_TYPES || callback == nullptr || subscriberCount_[index] >= MAX_PER_TYPE) {
+            rejectedSubscriptions_++;
+            return false;
+        }
+
+        subscribers_[index][subscriberCount_[index]++] = callback;
+        return true;
+    }
+
+    /**
+     * @brief At most one pending event of this type (repeated ones are merged)
+     */
+    template <typename Type>
+    void setCoalescing(Type type, bool enabled) {
+        const uint16_t bit = 1U << static_cast<uint8_t>(type);
+        coalescingMask_ = enabled ? (coalescingMask_ | bit) : (coalescingMask_ & ~bit);
+    }
+
+    /**
+     * @brief Event without payload
+     */
+    template <typename Type>
+    bool publish(Type type) {
+        Event event;
+        event.type = type;
+        return publish(event);
+    }
+
+    /**
+     * @brief Copy an event in the queue
+     * @return false if dropped (queue full); true if queued or merged
+     */
+    bool publish(const Event& event) {
+        const uint8_t index = indexOf(event);
+        if (index >= EVENT_TYPES) {
+            return false;
+        }
+
+        const uint16_t bit = 1U << index;
+        if ((coalescingMask_ & bit) && (pendingMask_ & bit)) {
+            coalesced_[index]++;
+            return true;
+        }
+
+        if (static_cast<uint8_t>(tail_ - head_) >= QUEUE_SIZE) {
+            dropped_[index]++;
+            return false;
+        }
+
+        queue_[tail_ & QUEUE_MASK] = event;
+        tail_++;
+        pendingMask_ |= bit & coalescingMask_;
+        return true;
+    }
+
+    /**
+     * @brief Deliver the pending events (also the ones published by the callbacks)
+     */
+    void process() {
+        while (head_ != tail_) {
+            const Event event = queue_[head_ & QUEUE_MASK];
+            head_++;
+
+            const uint8_t index = indexOf(event);
+            pendingMask_ &= ~(1U << index);
+
+            for (uint8_t i = 0; i < subscriberCount_[index]; i++) {
+                subscribers_[index][i](event);
+            }
+        }
+    }
+
+    uint8_t getPending() const {
+        return static_cast<uint8_t>(tail_ - head_);
+    }
+
+    template <typename Type>
+    uint16_t getDropped(Type type) const {
+        return dropped_[static_cast<uint8_t>(type)];
+    }
+
+    template <typename Type>
+    uint16_t getCoalesced(Type type) const {
+        return coalesced_[static_cast<uint8_t>(type)];
+    }
+
+    /**
+     * @brief Subscriptions refused since the start (capacity exceeded)
+     */
+    uint8_t getRejectedSubscriptions() const {
+        return rejectedSubscriptions_;
+    }
+};
+
+#endif // EVENT_DISPATCHER_H
@@ -0,0 +1,168 @@
+/**
+ * @file Fixed_Point.h
+ * @brief Integer fixed-point conversions of the sensor readings
+ * @version 1.0.0
+ *
+ * The AVR has no FPU and no divide instruction: one float multiply costs
+ * ~100-150 cycles and a 32-bit division ~600. Every conversion here is a
+ * multiply by a precomputed Q16 constant and a shift (~40 cycles with the
+ * hardware 8x8 multiplier), with rounding to the nearest.
+ *
+ *  - echo time (us)       -> distance (mm or cm)
+ *  - LM35/TMP35 ADC value -> temperature (centi-degrees Celsius)
+ *  - value on a scale     -> per mille (precomputed reciprocal)
+ *  - linear map           -> precomputed slope (replace map())
+ */
+
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <Arduino.h>
+
+namespace FixedPoint {
+
+constexpr uint8_t Q16_SHIFT = 16;
+constexpr uint32_t Q16_HALF = 1UL << (Q16_SHIFT - 1);
+
+/**
+ * @brief Q16 constant of a rational value, rounded (compile time)
+ */
+constexpr uint32_t toQ16(uint32_t numerator, uint32_t denominator) {
+    return ((numerator << Q16_SHIFT) + denominator / 2) / denominator;
+}
+
+// ==================== ULTRASONIC ====================
+
+// Sound at ~20 C: 343 m/s = 0.343 mm/us, halved for the round trip
+constexpr uint32_t ECHO_US_TO_MM_Q16 = toQ16(343, 2000);   // 0.1715 -> 11239
+constexpr uint32_t ECHO_US_TO_CM_Q16 = toQ16(343, 20000);  // 0.01715 -> 1124
+
+/**
+ * @brief Echo pulse width to distance in millimeters
+ * Valid up to 65535 us (the HC-SR04 echo ends at ~38 ms)
+ */
+inline uint16_t echoMicrosToMillimeters(uint16_t echoMicros) {
+    return static_cast<uint16_t>((echoMicros * ECHO_US_TO_MM_Q16 + Q16_HALF) >> Q16_SHIFT);
+}
+
+/**
+ * @brief Echo pulse width to distance in centimeters
+ */
+inline uint16_t echoMicrosToCentimeters(uint16_t echoMicros) {
+    return static_cast<uint16_t>((echoMicros * ECHO_US_TO_CM_Q16 + Q16_HALF) >> Q16_SHIFT);
+}
+
+// ==================== TEMPERATURE ====================
+
+/**
+ * @brief ADC value of an analog temperature sensor to centi-degrees Celsius
+ *
+ * 10 mV/C with 5 V reference: 1 LSB = 5000 mV / 1024 = 48.828 centi-C,
+ * exactly 3125/64, so a multiply and a shift are enough (rounded to the
+ * nearest centi-C by adding half of the divisor before the shift).
+ *
+ * @param adc ADC value with 10 + extraBits bits (oversampled values)
+ * @param extraBits Extra resolution bits of the value (0 for analogRead)
+ * @param offsetCentiCelsius Output voltage at 0 C (TMP35/36: 500 mV = 5000)
+ */
+inline int16_t adcToCentiCelsius(uint16_t adc, uint8_t extraBits = 0, int16_t offsetCentiCelsius = 0) {
+    const uint8_t shift = 6 + extraBits;
+    const int32_t centi = static_cast<int32_t>((static_cast<uint32_t>(adc) * 3125UL + (1UL << (shift - 1))) >> shift) -
+                          offsetCentiCelsius;
+
+    // Saturated: the full ADC scale (500 C) doesn't fit in int16_t
+    return centi > INT16_MAX ? INT16_MAX : static_cast<int16_t>(centi);
+}
+
+// ==================== SCALES ====================
+
+/**
+ * @brief Conversion of a value to per mille of a fixed full scale
+ * The reciprocal of the full scale is computed once (no division per sample)
+ */
+class PerMilleScale {
+private:
+    uint32_t reciprocalQ16_;
+    uint16_t fullScale_;
+
+public:
+    constexpr explicit PerMilleScale(uint16_t fullScale)
+        : reciprocalQ16_(toQ16(1000, fullScale)),
+          fullScale_(fullScale) {}
+
+    /**
+     * @brief Value to per mille, saturated to [0, 1000]
+     * Exact for full scales up to 65535 (product fits 32 bits)
+     */
+    uint16_t apply(uint16_t value) const {
+        if (value >= fullScale_) {
+            return 1000;
+        }
+        return static_cast<uint16_t>((value * reciprocalQ16_ + Q16_HALF) >> Q16_SHIFT);
+    }
+};
+
+/**
+ * @brief Linear map with a precomputed Q16 slope (replace map())
+ * The input is constrained to [inMin, inMax]
+ */
+class LinearMap {
+private:
+    int16_t inMin_;
+    int16_t inMax_;
+    int16_t outMin_;
+    int32_t slopeQ16_;
+
+public:
+    constexpr LinearMap(int16_t inMin, int16_t inMax, int16_t outMin, int16_t outMax)
+        : inMin_(inMin),
+          inMax_(inMax),
+          outMin_(outMin),
+          slopeQ16_((static_cast<int32_t>(outMax - outMin) * 65536L) / (inMax - inMin)) {}
+
+    int16_t apply(int16_t value) const {
+        if (value < inMin_) value = inMin_;
+        if (value > inMax_) value = inMax_;
+
+        const int32_t scaled = static_cast<int32_t>(value - inMin_) * slopeQ16_;
+        return static_cast<int16_t>(outMin_ + ((scaled + static_cast<int32_t>(Q16_HALF)) >> Q16_SHIFT));
+    }
+};
+
+// ==================== OUTPUT ====================
+
+/**
+ * @brief Print a fixed-point value with a number of decimals
+ * e.g. printFixed(out, 2537, 2) prints "25.37"
+ */
+inline size_t printFixed(Print& out, int32_t value, uint8_t decimals) {
+    size_t written = 0;
+
+    if (value < 0) {
+        written += out.print('-');
+        value = -value;
+    }
+
+    uint32_t divisor = 1;
+    for (uint8_t i = 0; i < decimals; i++) {
+        divisor *= 10;
+    }
+
+    written += out.print(static_cast<unsigned long>(value / divisor));
+
+    if (decimals > 0) {
+        written += out.print('.');
+
+        uint32_t fraction = static_cast<uint32_t>(value) % divisor;
+        for (divisor /= 10; divisor > 0; divisor /= 10) {
+            written += out.print(static_cast<char>('0' + fraction / divisor));
+            fraction %= divisor;
+        }
+    }
+
+    return written;
+}
+
+} // namespace FixedPoint
+
+#endif // FIXED_POINT_H
@@ -0,0 +1,188 @@
+/**
+ * @file Flow_Estimator.h
+ * @brief Streaming fill/drain rate (least-squares slope) and time to a level
+ * @version 1.0.0
+ *
+ * Keeps the last N timestamped samples in a ring and the least-squares
+ * sums of the window (n, Sx, Sy, Sxx, Sxy), updated in O(1) per sample:
+ *  - time x is counted from the oldest sample of the window, so removing
+ *    the oldest sample removes nothing from Sx, Sxx and Sxy
+ *  - the window is then rebased on the new oldest sample (exact integer
+ *    identities, no drift)
+ *
+ * Time unit is 128 ms (a shift of millis(), no division); one hour is
+ * exactly 28125 units. x is the shifted unsigned difference of millis()
+ * values, so the estimate is not disturbed by the millis() overflow
+ * (~49.7 days). The window span must stay under ~20 minutes (Sxx in 32
+ * bits with 16 samples).
+ *
+ * Usage:
+ *   FlowEstimator<16> flow(10);               // Rates under 10 units/h = stable
+ *   each 5 s: flow.addSample(millis(), levelMm);
+ *   flow.getRatePerHour();                    // mm/h (> 0 filling)
+ *   flow.secondsToReach(0);                   // Time to empty (-1 if not draining)
+ */
+
+#ifndef FLOW_ESTIMATOR_H
+#define FLOW_ESTIMATOR_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Least-squares slope of the last N samples
+ * @tparam N Window size (samples)
+ */
+template <uint8_t N>
+class FlowEstimator {
+public:
+    static constexpr uint8_t TIME_SHIFT = 7;                 // 1 unit = 128 ms
+    static constexpr int32_t UNITS_PER_HOUR = 3600000L >> TIME_SHIFT; // 28125
+    static constexpr uint8_t MIN_SAMPLES = 4;
+    static constexpr int32_t NOT_APPROACHING = -1;
+
+private:
+    static_assert(N >= MIN_SAMPLES && N <= 32, "FlowEstimator: window of 4 to 32 samples");
+
+    uint32_t times_[N];   // millis() of the samples
+    int16_t values_[N];
+    uint8_t oldest_;
+    uint8_t count_;
+
+    // millis() of x = 0: the oldest sample, moved by whole time units only
+    // so that every x keeps its value minus the shift after a rebase
+    uint32_t originMs_;
+
+    // Sums with x = (time - originMs_) >> TIME_SHIFT
+    int32_t sumX_;
+    int32_t sumY_;
+    int32_t sumXX_;
+    int32_t sumXY_;
+
+    int16_t minRate_;
+    int32_t rate_;        // Units per hour, updated on each sample
+    int16_t fitted_;      // Fitted value at the newest sample
+
+    /**
+     * @brief Move the origin of x forward by shift units
+     */
+    void rebase(int32_t shift) {
+        const int32_t n = count_;
+        sumXX_ += n * shift * shift - 2 * shift * sumX_;
+        sumXY_ -= shift * sumY_;
+        sumX_ -= n * shift;
+    }
+
+    void updateFit(int32_t newestX) {
+        const int32_t n = count_;
+        const int64_t denominator = static_cast<int64_t>(n) * sumXX_ - static_cast<int64_t>(sumX_) * sumX_;
+
+        if (count_ < MIN_SAMPLES || denominator == 0) {
+            rate_ = 0;
+            fitted_ = values_[(oldest_ + count_ - 1) % N];
+            return;
+        }
+
+        const int64_t numerator = static_cast<int64_t>(n) * sumXY_ - static_cast<int64_t>(sumX_) * sumY_;
+
+        rate_ = static_cast<int32_t>(numerator * UNITS_PER_HOUR / denominator);
+
+        // Line through the mean: y = (Sy + slope * (n * x - Sx)) / n
+        const int64_t fit = (static_cast<int64_t>(sumY_) * denominator +
+                             numerator * (n * newestX - sumX_)) / (n * denominator);
+        fitted_ = static_cast<int16_t>(fit);
+    }
+
+public:
+    /**
+     * @param minRatePerHour Rates below it (absolute) are taken as stable
+     */
+    explicit FlowEstimator(int16_t minRatePerHour = 0)
+        : times_(), values_(), oldest_(0), count_(0), originMs_(0),
+          sumX_(0), sumY_(0), sumXX_(0), sumXY_(0),
+          minRate_(minRatePerHour), rate_(0), fitted_(0) {}
+
+    /**
+     * @brief Add a sample, replacing the oldest one when the window is full
+     * @param timeMs Sample time (millis())
+     */
+    void addSample(uint32_t timeMs, int16_t value) {
+        if (count_ == N) {
+            // Oldest sample has x = 0: only its value leaves the sums
+            sumY_ -= values_[oldest_];
+            oldest_ = (oldest_ + 1) % N;
+            count_--;
+
+            // x of the new oldest sample (unsigned difference: wrap-safe)
+            const uint32_t shift = (times_[oldest_] - originMs_) >> TIME_SHIFT;
+            rebase(static_cast<int32_t>(shift));
+            originMs_ += shift << TIME_SHIFT;
+        }
+
+        if (count_ == 0) {
+            oldest_ = 0;
+            originMs_ = timeMs;
+            sumX_ = sumY_ = sumXX_ = sumXY_ = 0;
+        }
+
+        const uint8_t index = (oldest_ + count_) % N;
+        const int32_t x = static_cast<int32_t>((timeMs - originMs_) >> TIME_SHIFT);
+
+        times_[index] = timeMs;
+        values_[index] = value;
+        count_++;
+
+        sumX_ += x;
+        sumY_ += value;
+        sumXX_ += x * x;
+        sumXY_ += x * value;
+
+        updateFit(x);
+    }
+
+    void reset() {
+        count_ = 0;
+        rate_ = 0;
+    }
+
+    /**
+     * @brief Enough samples for a slope
+     */
+    bool isValid() const {
+        return count_ >= MIN_SAMPLES;
+    }
+
+    /**
+     * @brief Rate of change in units per hour (> 0 rising, 0 if stable or unknown)
+     */
+    int32_t getRatePerHour() const {
+        const int32_t magnitude = rate_ < 0 ? -rate_ : rate_;
+        return magnitude < minRate_ ? 0 : rate_;
+    }
+
+    /**
+     * @brief Fitted value at the newest sample (less noisy than the last sample)
+     */
+    int16_t getFittedValue() const {
+        return fitted_;
+    }
+
+    /**
+     * @brief Predicted time to reach a value at the current rate
+     * @return Seconds (0 if already there), NOT_APPROACHING if stable or going away
+     */
+    int32_t secondsToReach(int16_t target) const {
+        const int32_t rate = getRatePerHour();
+        const int32_t distance = static_cast<int32_t>(target) - fitted_;
+
+        if (distance == 0) {
+            return 0;
+        }
+        if (rate == 0 || (distance > 0) != (rate > 0)) {
+            return NOT_APPROACHING;
+        }
+
+        return distance * 3600L / rate;
+    }
+};
+
+#endif // FLOW_ESTIMATOR_H
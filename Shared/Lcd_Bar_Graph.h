@@ -0,0 +1,101 @@
+/**
+ * @file Lcd_Bar_Graph.h
+ * @brief High-resolution bar graph with partial-block glyphs of the HD44780
+ * @version 1.0.0
+ *
+ * A character cell is 5 pixel columns wide: with 4 custom glyphs in the
+ * CGRAM (1 to 4 columns filled) plus the space and the full block (255),
+ * a bar of N cells has 5 * N steps instead of N.
+ *
+ * The glyphs are loaded once at startup (loadGlyphs). The bar is drawn in
+ * a target with setCursor/write: drawn in an LcdFramebuffer, only the cell
+ * whose fill changed is sent on flush.
+ *
+ * Usage:
+ *   LcdBarGraph<6> bar(1000);          // 6 cells, 30 steps, full scale 1000
+ *   setup: bar.loadGlyphs(lcd);
+ *   loop:  bar.draw(screen, 10, 1, value);
+ */
+
+#ifndef LCD_BAR_GRAPH_H
+#define LCD_BAR_GRAPH_H
+
+#include <Arduino.h>
+#include "Fixed_Point.h"
+
+/**
+ * @brief Horizontal bar of CELLS characters
+ */
+template <uint8_t CELLS>
+class LcdBarGraph {
+public:
+    static constexpr uint8_t COLUMNS_PER_CELL = 5;
+    static constexpr uint8_t STEPS = CELLS * COLUMNS_PER_CELL;
+    static constexpr uint8_t GLYPH_COUNT = COLUMNS_PER_CELL - 1; // CGRAM slots used
+    static constexpr uint8_t FULL_BLOCK = 255;
+
+private:
+    static_assert(CELLS > 0 && CELLS <= 40, "LcdBarGraph: 1 to 40 cells");
+
+    uint32_t stepsQ16_;  // Steps per unit of value, Q16
+    uint16_t fullScale_;
+    uint8_t firstSlot_;
+
+public:
+    /**
+     * @param fullScale Value of the full bar
+     * @param firstSlot First CGRAM slot of the glyphs (slots firstSlot to firstSlot + 3)
+     */
+    explicit LcdBarGraph(uint16_t fullScale, uint8_t firstSlot = 0)
+        : stepsQ16_(FixedPoint::toQ16(STEPS, fullScale)),
+          fullScale_(fullScale),
+          firstSlot_(firstSlot) {}
+
+    /**
+     * @brief Write the partial-block glyphs in the CGRAM (once, after lcd.begin)
+     * The display address changes: set the cursor before printing again
+     */
+    template <typename Lcd>
+    void loadGlyphs(Lcd& lcd) const {
+        uint8_t rows[8];
+
+        for (uint8_t columns = 1; columns <= GLYPH_COUNT; columns++) {
+            // Filled from the left: 1 column = 0b10000
+            memset(rows, static_cast<uint8_t>((0x1F << (COLUMNS_PER_CELL - columns)) & 0x1F), sizeof(rows));
+            lcd.createChar(firstSlot_ + columns - 1, rows);
+        }
+    }
+
+    /**
+     * @brief Steps filled for a value (0 to STEPS), without division
+     */
+    uint8_t steps(uint16_t value) const {
+        if (value >= fullScale_) {
+            return STEPS;
+        }
+        return static_cast<uint8_t>((value * stepsQ16_ + FixedPoint::Q16_HALF) >> FixedPoint::Q16_SHIFT);
+    }
+
+    /**
+     * @brief Draw the bar (all its cells, filled or not)
+     */
+    template <typename Target>
+    void draw(Target& target, uint8_t col, uint8_t row, uint16_t value) const {
+        uint8_t remaining = steps(value);
+
+        target.setCursor(col, row);
+        for (uint8_t cell = 0; cell < CELLS; cell++) {
+            if (remaining >= COLUMNS_PER_CELL) {
+                target.write(FULL_BLOCK);
+                remaining -= COLUMNS_PER_CELL;
+            } else if (remaining > 0) {
+                target.write(static_cast<uint8_t>(firstSlot_ + remaining - 1));
+                remaining = 0;
+            } else {
+                target.write(' ');
+            }
+        }
+    }
+};
+
+#endif // LCD_BAR_GRAPH_H
@@ -0,0 +1,127 @@
+/**
+ * @file Lcd_Framebuffer.h
+ * @brief Shadow framebuffer for HD44780 displays: only changed cells are sent
+ * @version 1.0.0
+ *
+ * Replace lcd.clear() (~1.5 ms, visible flicker) and full rewrites by:
+ *  - the sketch printing the whole frame in RAM (clear, setCursor, print)
+ *  - flush() comparing it with what the display shows
+ *  - only the changed cells sent, one setCursor per run of changed cells
+ *
+ * The HD44780 increments its address after each character, so a run of
+ * changed cells costs one command plus one byte per cell. On the I2C
+ * backpack each byte is 4 bus writes: a value changing a few digits costs
+ * a few bytes instead of 32 or more.
+ *
+ * Works with LiquidCrystal and LiquidCrystal_I2C (any class with
+ * setCursor(col, row) and write(uint8_t)).
+ *
+ * Usage:
+ *   LcdFramebuffer<LiquidCrystal, 16, 2> screen(lcd);
+ *   screen.clear(); screen.setCursor(0, 0); screen.print("Level: ");
+ *   screen.flush(); // Sends the differences
+ */
+
+#ifndef LCD_FRAMEBUFFER_H
+#define LCD_FRAMEBUFFER_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Frame in RAM of a COLS x ROWS character display
+ * @tparam Lcd Display driver type
+ */
+template <typename Lcd, uint8_t COLS, uint8_t ROWS>
+class LcdFramebuffer : public Print {
+private:
+    static constexpr uint8_t NO_POSITION = 0xFF;
+
+    Lcd& lcd_;
+    uint8_t frame_[ROWS][COLS]; // Frame being drawn
+    uint8_t shown_[ROWS][COLS]; // Frame on the display
+    uint8_t col_;
+    uint8_t row_;
+    bool valid_;                // shown_ matches the display
+
+public:
+    explicit LcdFramebuffer(Lcd& lcd) : lcd_(lcd), col_(0), row_(0), valid_(false) {
+        clear();
+    }
+
+    /**
+     * @brief Fill the frame with spaces (nothing is sent)
+     */
+    void clear() {
+        memset(frame_, ' ', sizeof(frame_));
+        col_ = 0;
+        row_ = 0;
+    }
+
+    void setCursor(uint8_t col, uint8_t row) {
+        col_ = col;
+        row_ = row;
+    }
+
+    /**
+     * @brief Put a character in the frame (clipped at the end of the row)
+     */
+    size_t write(uint8_t character) override {
+        if (row_ >= ROWS || col_ >= COLS) {
+            return 0;
+        }
+
+        frame_[row_][col_++] = character;
+        return 1;
+    }
+
+    using Print::write;
+
+    /**
+     * @brief Character of the frame at a position (for widgets)
+     */
+    uint8_t at(uint8_t col, uint8_t row) const {
+        return (row < ROWS && col < COLS) ? frame_[row][col] : ' ';
+    }
+
+    /**
+     * @brief Redraw every cell on the next flush
+     * Must be called after the display is written directly (lcd.clear(), init)
+     */
+    void invalidate() {
+        valid_ = false;
+    }
+
+    /**
+     * @brief Send the changed cells to the display
+     * @return Number of characters sent
+     */
+    uint8_t flush() {
+        uint8_t sent = 0;
+
+        for (uint8_t row = 0; row < ROWS; row++) {
+            uint8_t cursor = NO_POSITION; // Column of the display address in this row
+
+            for (uint8_t col = 0; col < COLS; col++) {
+                const uint8_t character = frame_[row][col];
+
+                if (valid_ && shown_[row][col] == character) {
+                    continue;
+                }
+
+                if (cursor != col) {
+                    lcd_.setCursor(col, row);
+                }
+
+                lcd_.write(character);
+                shown_[row][col] = character;
+                cursor = col + 1;
+                sent++;
+            }
+        }
+
+        valid_ = true;
+        return sent;
+    }
+};
+
+#endif // LCD_FRAMEBUFFER_H
@@ -0,0 +1,171 @@
+/**
+ * @file Message_Buffer.h
+ * @brief Double-buffered text for scrolling displays, integer to ASCII writers
+ * @version 1.0.0
+ *
+ * MD_Parola keeps a pointer to the text while it scrolls: writing in that
+ * buffer changes the text in the middle of the animation. MessageBuffer
+ * keeps two copies:
+ *  - the front one, given to the display, not touched until the swap
+ *  - the back one, edited field by field (only what changed)
+ * swapIfDirty() is called when the scroll has finished.
+ *
+ * The TextFormat writers replace sprintf/dtostrf (no vfprintf linked):
+ * fixed width, so a field can be rewritten in place.
+ *
+ * Usage:
+ *   MessageBuffer<120> text;
+ *   char* out = text.edit() + offset; TextFormat::writeUnsigned(out, seconds, 2);
+ *   if (P.displayAnimate() && text.swapIfDirty()) P.displayText(text.front(), ...);
+ */
+
+#ifndef MESSAGE_BUFFER_H
+#define MESSAGE_BUFFER_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Two copies of a text of up to SIZE - 1 characters
+ */
+template <uint8_t SIZE>
+class MessageBuffer {
+private:
+    char buffers_[2][SIZE];
+    uint8_t front_;
+    bool dirty_;
+
+public:
+    MessageBuffer() : front_(0), dirty_(false) {
+        buffers_[0][0] = '\0';
+        buffers_[1][0] = '\0';
+    }
+
+    /**
+     * @brief Text shown (stable until the next swap)
+     */
+    const char* front() const {
+        return buffers_[front_];
+    }
+
+    /**
+     * @brief Back buffer to edit; marks the text as changed
+     */
+    char* edit() {
+        dirty_ = true;
+        return buffers_[front_ ^ 1];
+    }
+
+    /**
+     * @brief Latest text (back buffer), e.g. to print it
+     */
+    const char* latest() const {
+        return buffers_[front_ ^ 1];
+    }
+
+    bool isDirty() const {
+        return dirty_;
+    }
+
+    static constexpr uint8_t capacity() {
+        return SIZE;
+    }
+
+    /**
+     * @brief Show the edited text: swap, and copy it in the new back buffer
+     * (the next edits start from the text shown)
+     * @return false if nothing changed since the last swap
+     */
+    bool swapIfDirty() {
+        if (!dirty_) {
+            return false;
+        }
+
+        front_ ^= 1;
+        memcpy(buffers_[front_ ^ 1], buffers_[front_], SIZE);
+        dirty_ = false;
+        return true;
+    }
+};
+
+namespace TextFormat {
+
+/**
+ * @brief Copy a text (without the terminator)
+ * @return Position after the text
+ */
+inline char* writeText(char* out, const char* text) {
+    while (*text != '\0') {
+        *out++ = *text++;
+    }
+    return out;
+}
+
+/**
+ * @brief Unsigned value in exactly width characters, right aligned
+ * Digits beyond the width are lost (the field keeps its size)
+ * @return Position after the field
+ */
+inline char* writeUnsigned(char* out, uint16_t value, uint8_t width, char pad = '0') {
+    char* end = out + width;
+    char* digit = end;
+
+    do {
+        *--digit = '0' + value % 10;
+        value /= 10;
+    } while (value != 0 && digit > out);
+
+    while (digit > out) {
+        *--digit = pad;
+    }
+    return end;
+}
+
+/**
+ * @brief Tenths with one decimal in exactly width characters ("-10.1", " 24.8")
+ * @return Position after the field
+ */
+inline char* writeTenths(char* out, int16_t tenths, uint8_t width) {
+    const bool negative = tenths < 0;
+    const uint16_t magnitude = negative ? -static_cast<int32_t>(tenths) : tenths;
+
+    char* end = out + width;
+    char* digit = end;
+
+    *--digit = '0' + magnitude % 10;
+    *--digit = '.';
+
+    uint16_t units = magnitude / 10;
+    do {
+        *--digit = '0' + units % 10;
+        units /= 10;
+    } while (units != 0 && digit > out);
+
+    if (negative && digit > out) {
+        *--digit = '-';
+    }
+    while (digit > out) {
+        *--digit = ' ';
+    }
+    return end;
+}
+
+/**
+ * @brief Text right aligned in exactly width characters (truncated if longer)
+ * @return Position after the field
+ */
+inline char* writePadded(char* out, const char* text, uint8_t width) {
+    const uint8_t length = strlen(text);
+    char* end = out + width;
+
+    for (uint8_t i = length; i < width; i++) {
+        *out++ = ' ';
+    }
+    while (out < end && *text != '\0') {
+        *out++ = *text++;
+    }
+    return end;
+}
+
+} // namespace TextFormat
+
+#endif // MESSAGE_BUFFER_H
@@ -0,0 +1,338 @@
+/**
+ * @file Perf_Probe.h
+ * @brief Cycle-accurate scoped probes, log2 histograms and loop jitter in fixed RAM
+ * @version 1.0.0
+ *
+ * Measure where the time goes (a blocking read, an LCD refresh, a TFT
+ * burst, a task activation) before and after an optimization:
+ *  - clock: Timer1 free running at F_CPU (62.5 ns at 16 MHz), extended to
+ *    32 bits by its overflow interrupt (every 4.096 ms)
+ *  - per probe: count, min, max, average, and a histogram of 16 log2
+ *    buckets (bucket i from 2^(i+4) cycles, i.e. 2^i us at 16 MHz; the
+ *    last one is open)
+ *  - PerfScope: RAII probe around a block; mark(): period between two
+ *    calls (loop period and jitter, task activation period)
+ *  - dump(): one compact line per probe, then a new window
+ *
+ * Every update is a short critical section (interrupts off), so probes
+ * can be used from the bare sketches, from FreeRTOS tasks (its AVR port
+ * ticks on the watchdog, Timer1 is free) and from ISRs.
+ *
+ * Usage:
+ *   #define PERF_PROBE_DEFINE_STATICS   // In one file of the sketch
+ *   PerfProbe::begin();
+ *   const uint8_t probeDisplay = PerfProbe::define(F("display"));
+ *   void updateDisplay() { PerfScope scope(probeDisplay); ... }
+ *   loop: PerfProbe::mark(probeLoop); PerfProbe::dumpEvery(Serial, 10000);
+ *
+ * Output: "display n:20 min:812.4 avg:845.0 max:1210.1us h9:4/15/1"
+ * (h9: counts of buckets 9, 10, 11...; empty buckets at both ends skipped)
+ *
+ * Options (define before the include):
+ *  - PERF_PROBE_DISABLED: every call does nothing (probes stay in the code)
+ *  - PERF_PROBE_MICROS_CLOCK: micros() as clock (4 us resolution), when
+ *    Timer1 is used by the sketch (Servo, Timebase::beginTimer1)
+ *  - PERF_PROBE_SLOTS: number of probes (default 4, 56 bytes each)
+ */
+
+#ifndef PERF_PROBE_H
+#define PERF_PROBE_H
+
+#include <Arduino.h>
+
+#ifndef PERF_PROBE_SLOTS
+#define PERF_PROBE_SLOTS 4
+#endif
+
+/**
+ * @brief Global probe table (one per sketch)
+ *
+ * Static engine, extended by the Timer1 overflow interrupt (see
+ * Shared/README.md).
+ */
+class PerfProbe {
+public:
+    static constexpr uint8_t INVALID_PROBE = 0xFF;
+    static constexpr uint8_t BUCKETS = 16;
+    static constexpr uint8_t FIRST_BUCKET_SHIFT = 4;  // Bucket 1 starts at 2^5 cycles
+    static constexpr uint32_t CYCLES_PER_MICRO = F_CPU / 1000000UL;
+
+#ifdef PERF_PROBE_DISABLED
+    static constexpr bool ENABLED = false;
+#else
+    static constexpr bool ENABLED = true;
+#endif
+
+private:
+    struct Probe {
+        const __FlashStringHelper* name;
+        uint32_t count;
+        uint32_t minCycles;
+        uint32_t maxCycles;
+        uint32_t sumCycles;    // Window sum (wraps after ~268 s of measured time)
+        uint32_t lastMark;
+        bool marked;
+        uint16_t histogram[BUCKETS];
+    };
+
+    static Probe probes_[PERF_PROBE_SLOTS];
+    static uint8_t count_;
+    static volatile uint16_t overflows_;
+    static uint32_t windowStart_;   // millis() of the last dump
+
+    static uint8_t bucketOf(uint32_t cycles) {
+        uint8_t bucket = 0;
+        cycles >>= FIRST_BUCKET_SHIFT + 1;
+        while (cycles != 0 && bucket < BUCKETS - 1) {
+            cycles >>= 1;
+            bucket++;
+        }
+        return bucket;
+    }
+
+    static void clearWindow(Probe& probe) {
+        probe.count = 0;
+        probe.minCycles = 0xFFFFFFFFUL;
+        probe.maxCycles = 0;
+        probe.sumCycles = 0;
+        for (uint8_t i = 0; i < BUCKETS; i++) {
+            probe.histogram[i] = 0;
+        }
+    }
+
+    /**
+     * @brief Cycles in microseconds with one decimal ("812.4")
+     */
+    static void printMicros(Print& out, uint32_t cycles) {
+        const uint32_t tenths = cycles * 10 / CYCLES_PER_MICRO;
+        out.print(tenths / 10);
+        out.print('.');
+        out.print(static_cast<uint8_t>(tenths % 10));
+    }
+
+public:
+    /**
+     * @brief Start the clock (Timer1 free running; nothing with the micros() clock)
+     */
+    static void begin() {
+        if (!ENABLED) {
+            return;
+        }
+
+#ifndef PERF_PROBE_MICROS_CLOCK
+        const uint8_t oldSREG = SREG;
+        cli();
+        TCCR1A = 0;                  // Normal mode, TOP = 0xFFFF
+        TCCR1B = _BV(CS10);          // No prescaler: one count per CPU cycle
+        TCNT1 = 0;
+        overflows_ = 0;
+        TIFR1 = _BV(TOV1);
+        TIMSK1 = _BV(TOIE1);
+        SREG = oldSREG;
+#endif
+        windowStart_ = millis();
+    }
+
+    /**
+     * @brief Register a probe
+     * @param name Name printed by dump (F() string)
+     * @return Probe index, INVALID_PROBE if the table is full
+     */
+    static uint8_t define(const __FlashStringHelper* name) {
+        if (!ENABLED || count_ >= PERF_PROBE_SLOTS) {
+            return INVALID_PROBE;
+        }
+
+        Probe& probe = probes_[count_];
+        probe.name = name;
+        probe.marked = false;
+        clearWindow(probe);
+        return count_++;
+    }
+
+    /**
+     * @brief CPU cycles since begin (wraps every 2^32 cycles, ~268 s at 16 MHz)
+     */
+    static uint32_t cycles() {
+#ifdef PERF_PROBE_MICROS_CLOCK
+        return micros() * CYCLES_PER_MICRO;
+#else
+        const uint8_t oldSREG = SREG;
+        cli();
+        const uint16_t low = TCNT1;
+        uint16_t high = overflows_;
+
+        // Overflow pending (not yet counted by the ISR) and read after it
+        if ((TIFR1 & _BV(TOV1)) && low < 0x8000) {
+            high++;
+        }
+        SREG = oldSREG;
+
+        return (static_cast<uint32_t>(high) << 16) | low;
+#endif
+    }
+
+    /**
+     * @brief Account one measured duration
+     */
+    static void record(uint8_t id, uint32_t elapsedCycles) {
+        if (!ENABLED || id >= count_) {
+            return;
+        }
+
+        const uint8_t bucket = bucketOf(elapsedCycles);
+        Probe& probe = probes_[id];
+
+        const uint8_t oldSREG = SREG;
+        cli();
+        probe.count++;
+        probe.sumCycles += elapsedCycles;
+        if (elapsedCycles < probe.minCycles) probe.minCycles = elapsedCycles;
+        if (elapsedCycles > probe.maxCycles) probe.maxCycles = elapsedCycles;
+        if (probe.histogram[bucket] < 0xFFFF) probe.histogram[bucket]++;
+        SREG = oldSREG;
+    }
+
+    /**
+     * @brief Account the period since the previous mark of this probe
+     * (max - min of the window is the jitter)
+     */
+    static void mark(uint8_t id) {
+        if (!ENABLED || id >= count_) {
+            return;
+        }
+
+        const uint32_t now = cycles();
+        Probe& probe = probes_[id];
+
+        if (probe.marked) {
+            record(id, now - probe.lastMark);
+        }
+        probe.lastMark = now;
+        probe.marked = true;
+    }
+
+    /**
+     * @brief Print one line per probe with samples, then start a new window
+     */
+    static void dump(Print& out) {
+        if (!ENABLED) {
+            return;
+        }
+
+        const uint32_t now = millis();
+        out.print(F("perf "));
+        out.print(now - windowStart_);
+        out.println(F("ms"));
+        windowStart_ = now;
+
+        for (uint8_t id = 0; id < count_; id++) {
+            // Copy and clear the window
+            const uint8_t oldSREG = SREG;
+            cli();
+            const Probe probe = probes_[id];
+            clearWindow(probes_[id]);
+            SREG = oldSREG;
+
+            if (probe.count == 0) {
+                continue;
+            }
+
+            out.print(F("  "));
+            out.print(probe.name);
+            out.print(F(" n:"));
+            out.print(probe.count);
+            out.print(F(" min:"));
+            printMicros(out, probe.minCycles);
+            out.print(F(" avg:"));
+            printMicros(out, probe.sumCycles / probe.count);
+            out.print(F(" max:"));
+            printMicros(out, probe.maxCycles);
+            out.print(F("us h"));
+
+            uint8_t first = 0;
+            uint8_t last = BUCKETS - 1;
+            while (probe.histogram[first] == 0) first++;
+            while (probe.histogram[last] == 0) last--;
+
+            out.print(first);
+            out.print(':');
+            for (uint8_t i = first; i <= last; i++) {
+                if (i != first) out.print('/');
+                out.print(probe.histogram[i]);
+            }
+            out.println();
+        }
+    }
+
+    /**
+     * @brief dump() when periodMs passed since the last one
+     * @return true if printed
+     */
+    static bool dumpEvery(Print& out, uint32_t periodMs) {
+        if (!ENABLED || millis() - windowStart_ < periodMs) {
+            return false;
+        }
+        dump(out);
+        return true;
+    }
+
+    /**
+     * @brief Worst duration of the current window (cycles, 0 if none)
+     */
+    static uint32_t getMaxCycles(uint8_t id) {
+        if (!ENABLED || id >= count_) {
+            return 0;
+        }
+
+        const uint8_t oldSREG = SREG;
+        cli();
+        const uint32_t maxCycles = probes_[id].maxCycles;
+        SREG = oldSREG;
+        return maxCycles;
+    }
+
+    /**
+     * @brief Timer1 overflow handler (extends the counter to 32 bits)
+     */
+    static void handleOverflow() {
+        overflows_ = overflows_ + 1;
+    }
+};
+
+/**
+ * @brief RAII probe: measures from the construction to the end of the block
+ */
+class PerfScope {
+private:
+    uint8_t id_;
+    uint32_t start_;
+
+public:
+    explicit PerfScope(uint8_t id)
+        : id_(id),
+          start_(PerfProbe::ENABLED ? PerfProbe::cycles() : 0) {}
+
+    ~PerfScope() {
+        if (PerfProbe::ENABLED) {
+            PerfProbe::record(id_, PerfProbe::cycles() - start_);
+        }
+    }
+
+    // Delete copy constructor and assignment operator
+    PerfScope(const PerfScope&) = delete;
+    PerfScope& operator=(const PerfScope&) = delete;
+};
+
+#ifdef PERF_PROBE_DEFINE_STATICS
+PerfProbe::Probe PerfProbe::probes_[PERF_PROBE_SLOTS];
+uint8_t PerfProbe::count_ = 0;
+volatile uint16_t PerfProbe::overflows_ = 0;
+uint32_t PerfProbe::windowStart_ = 0;
+
+#if !defined(PERF_PROBE_DISABLED) && !defined(PERF_PROBE_MICROS_CLOCK)
+ISR(TIMER1_OVF_vect) { PerfProbe::handleOverflow(); }
+#endif
+#endif // PERF_PROBE_DEFINE_STATICS
+
+#endif // PERF_PROBE_H
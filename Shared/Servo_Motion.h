@@ -0,0 +1,256 @@
+/**
+ * @file Servo_Motion.h
+ * @brief Timer-driven servo trajectory: deadband, trapezoidal speed profile
+ * @version 1.0.0
+ *
+ * Replace the jump of the servo to each new target (mechanical jerk,
+ * current spikes, jitter when the target wobbles) by:
+ *  - a deadband: targets closer than it to the current target are ignored
+ *  - a speed and acceleration limited ramp toward the target, stepped at
+ *    50 Hz by Timer2 (one step per servo frame of 20 ms): accelerate, cruise
+ *    at the maximum speed, brake as soon as the stopping distance reaches
+ *    the remaining distance (no sqrt: v^2 / 2a + v / 2 compared with d)
+ *  - the pulse written with writeMicroseconds (~10 steps per degree
+ *    instead of 1 with write())
+ *
+ * Position and speed are in 1/256 us (Q8), so low accelerations still move.
+ * Sensing and actuation are decoupled: the loop sets the target at its own
+ * rate, the ramp runs in the interrupt.
+ *
+ * Usage:
+ *   #define SERVO_MOTION_DEFINE_STATICS   // In one file of the sketch
+ *   ServoMotion::begin(servo, 1500, 3000, 15000, 20); // Center, 3000 us/s, 15000 us/s^2, 20 us
+ *   loop: ServoMotion::setTarget(pulseUs);
+ *
+ * Timer2 is also used by tone(), the Alarm_Engine and PWM on pins 3/11 of
+ * the Uno: don't mix them. Define SERVO_MOTION_NO_ISR to write
+ * TIMER2_COMPA_vect yourself and call ServoMotion::handleTick() at 100 Hz.
+ */
+
+#ifndef SERVO_MOTION_H
+#define SERVO_MOTION_H
+
+#include <Arduino.h>
+#include <Servo.h>
+
+/**
+ * @brief Trajectory of one servo, stepped by the Timer2 interrupt
+ *
+ * Static engine, stepped by the Timer2 interrupt (see Shared/README.md).
+ */
+class ServoMotion {
+public:
+    static constexpr uint8_t STEP_HZ = 50;
+    static constexpr uint16_t MIN_PULSE_US = 544;   // Servo library limits
+    static constexpr uint16_t MAX_PULSE_US = 2400;
+
+private:
+    // Timer2 CTC: F_CPU / 1024 / 156 = 100.2 Hz at 16 MHz, one step every 2 ticks
+    static constexpr uint8_t TIMER_COUNTS = F_CPU / 1024 / (2 * STEP_HZ);
+    static constexpr uint8_t TICKS_PER_STEP = 2;
+    static constexpr uint8_t Q8_SHIFT = 8;
+    static constexpr int32_t MAX_SPEED_Q8 = 40000;  // v^2 in 32 bits (~7800 us/s)
+
+    static Servo* servo_;
+    static uint16_t deadband_;
+    static int32_t maxSpeed_;      // Q8 us per step
+    static int32_t acceleration_;  // Q8 us per step^2
+    static volatile uint16_t target_;
+    static volatile int32_t position_;  // Q8 us
+    static volatile int32_t speed_;     // Q8 us per step
+    static uint16_t written_;
+    static uint8_t ticks_;
+
+    static int32_t absolute(int32_t value) {
+        return value < 0 ? -value : value;
+    }
+
+    static uint16_t clampPulse(uint16_t pulseUs) {
+        if (pulseUs < MIN_PULSE_US) return MIN_PULSE_US;
+        if (pulseUs > MAX_PULSE_US) return MAX_PULSE_US;
+        return pulseUs;
+    }
+
+    /**
+     * @brief The ramp can stop within distance after a step at speed
+     * (the next steps are speed - a, speed - 2a, ...: v^2 / 2a + v / 2 in all)
+     */
+    static bool canStop(int32_t speed, int32_t distance) {
+        return (speed * speed) / (2 * acceleration_) + speed / 2 <= distance;
+    }
+
+    /**
+     * @brief One step of the trapezoidal profile
+     */
+    static void step() {
+        const int32_t goal = static_cast<int32_t>(target_) << Q8_SHIFT;
+        const int32_t distance = goal - position_;
+        int32_t speed = speed_;
+
+        if (distance == 0 && speed == 0) {
+            return;
+        }
+
+        const int32_t direction = distance >= 0 ? 1 : -1;
+        const int32_t remaining = absolute(distance);
+
+        if (speed * direction < 0) {
+            // Moving away from the target (it changed): brake first
+            speed += direction * acceleration_;
+        } else {
+            // Fastest of accelerate, cruise, brake that still stops in time
+            const int32_t current = absolute(speed);
+            int32_t next = current + acceleration_;
+            if (next > maxSpeed_) {
+                next = maxSpeed_;
+            }
+            if (!canStop(next, remaining)) {
+                next = current;
+                if (!canStop(next, remaining)) {
+                    next = current > acceleration_ ? current - acceleration_ : 0;
+                }
+            }
+            speed = direction * next;
+        }
+
+        // Arrived: the rest is less than one acceleration step
+        if (remaining <= acceleration_ && absolute(speed) <= acceleration_) {
+            position_ = goal;
+            speed_ = 0;
+        } else {
+            position_ += speed;
+            speed_ = speed;
+        }
+
+        const uint16_t pulse = static_cast<uint16_t>((position_ + (1L << (Q8_SHIFT - 1))) >> Q8_SHIFT);
+        if (pulse != written_) {
+            written_ = pulse;
+            servo_->writeMicroseconds(pulse);
+        }
+    }
+
+public:
+    /**
+     * @brief Start the trajectory from a pulse, and the 50 Hz steps
+     * @param servo Attached servo
+     * @param startUs Initial pulse (written at once)
+     * @param maxSpeedUsPerSecond Cruise speed, pulse us per second
+     * @param accelerationUsPerSecond2 Acceleration and braking, pulse us per second^2
+     * @param deadbandUs Target changes up to it are ignored
+     */
+    static void begin(Servo& servo, uint16_t startUs, uint16_t maxSpeedUsPerSecond,
+                      uint16_t accelerationUsPerSecond2, uint16_t deadbandUs) {
+        startUs = clampPulse(startUs);
+
+        const uint8_t oldSREG = SREG;
+        cli();
+
+        servo_ = &servo;
+        deadband_ = deadbandUs;
+        maxSpeed_ = (static_cast<int32_t>(maxSpeedUsPerSecond) << Q8_SHIFT) / STEP_HZ;
+        acceleration_ = (static_cast<int32_t>(accelerationUsPerSecond2) << Q8_SHIFT) /
+                        (static_cast<int32_t>(STEP_HZ) * STEP_HZ);
+        if (maxSpeed_ < 1) maxSpeed_ = 1;
+        if (maxSpeed_ > MAX_SPEED_Q8) maxSpeed_ = MAX_SPEED_Q8;
+        if (acceleration_ < 1) acceleration_ = 1;
+
+        target_ = startUs;
+        position_ = static_cast<int32_t>(startUs) << Q8_SHIFT;
+        speed_ = 0;
+        written_ = startUs;
+        ticks_ = 0;
+        servo.writeMicroseconds(startUs);
+
+        TCCR2A = _BV(WGM21);                        // CTC, TOP = OCR2A
+        TCCR2B = _BV(CS22) | _BV(CS21) | _BV(CS20); // Prescaler 1024
+        OCR2A = TIMER_COUNTS - 1;
+        TCNT2 = 0;
+        TIMSK2 = _BV(OCIE2A);
+
+        SREG = oldSREG;
+    }
+
+    /**
+     * @brief Stop the steps (the servo keeps its last pulse)
+     */
+    static void end() {
+        TIMSK2 &= ~_BV(OCIE2A);
+        speed_ = 0;
+    }
+
+    /**
+     * @brief New target pulse
+     * @return false if within the deadband of the current target (ignored)
+     */
+    static bool setTarget(uint16_t pulseUs) {
+        pulseUs = clampPulse(pulseUs);
+
+        const uint16_t current = getTarget();
+        const uint16_t change = pulseUs > current ? pulseUs - current : current - pulseUs;
+        if (change <= deadband_) {
+            return false;
+        }
+
+        const uint8_t oldSREG = SREG;
+        cli();
+        target_ = pulseUs;
+        SREG = oldSREG;
+        return true;
+    }
+
+    static uint16_t getTarget() {
+        const uint8_t oldSREG = SREG;
+        cli();
+        const uint16_t target = target_;
+        SREG = oldSREG;
+        return target;
+    }
+
+    /**
+     * @brief Pulse written to the servo
+     */
+    static uint16_t getPosition() {
+        const uint8_t oldSREG = SREG;
+        cli();
+        const uint16_t position = written_;
+        SREG = oldSREG;
+        return position;
+    }
+
+    static bool isMoving() {
+        const uint8_t oldSREG = SREG;
+        cli();
+        const bool moving = speed_ != 0 || position_ != (static_cast<int32_t>(target_) << Q8_SHIFT);
+        SREG = oldSREG;
+        return moving;
+    }
+
+    /**
+     * @brief Timer2 compare handler (100 Hz, one step every 2 calls)
+     */
+    static void handleTick() {
+        if (servo_ == nullptr || ++ticks_ < TICKS_PER_STEP) {
+            return;
+        }
+        ticks_ = 0;
+        step();
+    }
+};
+
+#ifdef SERVO_MOTION_DEFINE_STATICS
+Servo* ServoMotion::servo_ = nullptr;
+uint16_t ServoMotion::deadband_ = 0;
+int32_t ServoMotion::maxSpeed_ = 1;
+int32_t ServoMotion::acceleration_ = 1;
+volatile uint16_t ServoMotion::target_ = 1500;
+volatile int32_t ServoMotion::position_ = 1500L << 8;
+volatile int32_t ServoMotion::speed_ = 0;
+uint16_t ServoMotion::written_ = 1500;
+uint8_t ServoMotion::ticks_ = 0;
+
+#ifndef SERVO_MOTION_NO_ISR
+ISR(TIMER2_COMPA_vect) { ServoMotion::handleTick(); }
+#endif
+#endif // SERVO_MOTION_DEFINE_STATICS
+
+#endif // SERVO_MOTION_H
@@ -0,0 +1,213 @@
+/**
+ * @file Signal_Filters.h
+ * @brief Allocation-free filter pipeline for the sensor readings
+ * @version 1.0.0
+ *
+ * Compile-time sized stages on int16_t samples (cm, mm, centi-C, ...):
+ *  - OutlierGate:       range check and rate-of-change rejection
+ *  - MedianFilter:      median of the last N samples (spikes, bad echoes)
+ *  - ExponentialFilter: EMA with a power of two weight (jitter)
+ *
+ * The stages are chained with FilterChain. A stage may drop a sample
+ * (apply() returns false): the chain stops and the output is unchanged,
+ * instead of feeding an old value back into the average.
+ *
+ * Usage:
+ *   FilterChain<OutlierGate<2, 200, 30>, MedianFilter<5>, ExponentialFilter<2>> filter;
+ *   int16_t output;
+ *   if (filter.apply(sample, output)) { ... }
+ */
+
+#ifndef SIGNAL_FILTERS_H
+#define SIGNAL_FILTERS_H
+
+#include <Arduino.h>
+
+namespace SignalFilters {
+
+/**
+ * @brief Reject samples out of range or jumping too fast
+ *
+ * A step larger than MAX_STEP from the last accepted sample is taken as
+ * an outlier. After MAX_REJECTS consecutive step rejections the sample
+ * is accepted, so a real fast change is followed with a short delay.
+ *
+ * @tparam MIN_VALUE Minimum valid sample
+ * @tparam MAX_VALUE Maximum valid sample
+ * @tparam MAX_STEP Maximum change between two samples
+ * @tparam MAX_REJECTS Consecutive rejections before a resync
+ */
+template <int16_t MIN_VALUE, int16_t MAX_VALUE, int16_t MAX_STEP, uint8_t MAX_REJECTS = 3>
+class OutlierGate {
+private:
+    static_assert(MIN_VALUE <= MAX_VALUE, "OutlierGate: empty range");
+    static_assert(MAX_STEP > 0, "OutlierGate: MAX_STEP must be positive");
+
+    int16_t last_;
+    uint8_t rejects_;
+    bool hasLast_;
+
+public:
+    OutlierGate() : last_(0), rejects_(0), hasLast_(false) {}
+
+    bool apply(int16_t input, int16_t& output) {
+        if (input < MIN_VALUE || input > MAX_VALUE) {
+            return false; // Invalid reading (timeout, out of range)
+        }
+
+        const int16_t step = input > last_ ? input - last_ : last_ - input;
+
+        if (hasLast_ && step > MAX_STEP && rejects_ < MAX_REJECTS) {
+            rejects_++;
+            return false;
+        }
+
+        last_ = input;
+        rejects_ = 0;
+        hasLast_ = true;
+        output = input;
+        return true;
+    }
+
+    void reset() {
+        rejects_ = 0;
+        hasLast_ = false;
+    }
+};
+
+/**
+ * @brief Median of the last N samples
+ * Before N samples, the median of the samples received
+ *
+ * @tparam N Window size (odd, small: 3, 5, 7)
+ */
+template <uint8_t N>
+class MedianFilter {
+private:
+    static_assert(N % 2 == 1, "MedianFilter: N must be odd");
+    static_assert(N <= 15, "MedianFilter: use a small window (insertion sort)");
+
+    int16_t window_[N];
+    uint8_t index_;
+    uint8_t count_;
+
+public:
+    MedianFilter() : window_(), index_(0), count_(0) {}
+
+    bool apply(int16_t input, int16_t& output) {
+        window_[index_] = input;
+        index_ = (index_ + 1) % N;
+        if (count_ < N) {
+            count_++;
+        }
+
+        // Insertion sort of a copy (N is small)
+        int16_t sorted[N];
+        for (uint8_t i = 0; i < count_; i++) {
+            const int16_t value = window_[i];
+            uint8_t j = i;
+            while (j > 0 && sorted[j - 1] > value) {
+                sorted[j] = sorted[j - 1];
+                j--;
+            }
+            sorted[j] = value;
+        }
+
+        output = sorted[count_ / 2];
+        return true;
+    }
+
+    void reset() {
+        index_ = 0;
+        count_ = 0;
+    }
+};
+
+/**
+ * @brief Exponential moving average: y += (x - y) / 2^SHIFT
+ *
+ * The step is rounded away from zero, so the output reaches the input
+ * exactly on a constant signal (no truncation bias with int16_t state).
+ * The first sample initializes the state.
+ *
+ * @tparam SHIFT Weight of the new sample is 1/2^SHIFT
+ */
+template <uint8_t SHIFT>
+class ExponentialFilter {
+private:
+    static_assert(SHIFT > 0 && SHIFT < 8, "ExponentialFilter: SHIFT out of range");
+
+    int16_t state_;
+    bool initialized_;
+
+public:
+    ExponentialFilter() : state_(0), initialized_(false) {}
+
+    bool apply(int16_t input, int16_t& output) {
+        if (!initialized_) {
+            state_ = input;
+            initialized_ = true;
+        } else {
+            const int16_t difference = input - state_;
+            int16_t step = difference / (1 << SHIFT);
+
+            if (step == 0 && difference != 0) {
+                step = difference > 0 ? 1 : -1;
+            }
+            state_ += step;
+        }
+
+        output = state_;
+        return true;
+    }
+
+    void reset() {
+        initialized_ = false;
+    }
+};
+
+/**
+ * @brief Chain of filter stages, applied in order
+ */
+template <typename... Stages>
+class FilterChain;
+
+template <>
+class FilterChain<> {
+public:
+    bool apply(int16_t input, int16_t& output) {
+        output = input;
+        return true;
+    }
+
+    void reset() {}
+};
+
+template <typename First, typename... Rest>
+class FilterChain<First, Rest...> {
+private:
+    First first_;
+    FilterChain<Rest...> rest_;
+
+public:
+    /**
+     * @brief Filter one sample
+     * @return false if a stage dropped the sample (output unchanged)
+     */
+    bool apply(int16_t input, int16_t& output) {
+        int16_t intermediate;
+        if (!first_.apply(input, intermediate)) {
+            return false;
+        }
+        return rest_.apply(intermediate, output);
+    }
+
+    void reset() {
+        first_.reset();
+        rest_.reset();
+    }
+};
+
+} // namespace SignalFilters
+
+#endif // SIGNAL_FILTERS_H
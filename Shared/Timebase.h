@@ -0,0 +1,342 @@
+/**
+ * @file Timebase.h
+ * @brief Wall-clock timebase: 1 Hz interrupt, epoch counter, lazy calendar
+ * @version 1.0.0
+ *
+ * Replace the clock derived from millis() (resonator drift, lost at each
+ * power cycle) by:
+ *  - a 1 Hz interrupt incrementing a counter of epoch seconds (UTC):
+ *    the SQW output of a DS3231 (temperature-compensated, battery backed)
+ *    or, without RTC, Timer1 in CTC mode
+ *  - the calendar computed only when asked and the second changed
+ *    (leap years included), with the time zone offset in seconds
+ *
+ * The DS3231 keeps UTC; its time is read once at begin, then the SQW
+ * edges are counted (same oscillator, no drift between the two).
+ *
+ * Usage:
+ *   #define TIMEBASE_DEFINE_STATICS   // In one file of the sketch
+ *   if (!Timebase::beginDs3231(3)) Timebase::beginTimer1();
+ *   Timebase::setTimeZone(-3 * 3600L);
+ *   loop: if (Timebase::secondChanged()) { const Calendar& now = Timebase::localTime(); ... }
+ *
+ * Timer1 is also used by the Servo library: define TIMEBASE_NO_TIMER1_ISR
+ * to write TIMER1_COMPA_vect yourself and call Timebase::tick().
+ */
+
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+/**
+ * @brief Broken-down date and time
+ */
+struct Calendar {
+    uint16_t year;
+    uint8_t month;     // 1 to 12
+    uint8_t day;       // 1 to 31
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+    uint8_t dayOfWeek; // 0 = Sunday
+};
+
+/**
+ * @brief Epoch seconds counter driven by a 1 Hz interrupt
+ *
+ * There is one clock: static engine (see Shared/README.md).
+ */
+class Timebase {
+public:
+    static constexpr uint8_t DS3231_ADDRESS = 0x68;
+
+    /**
+     * @brief Source of the 1 Hz tick
+     */
+    enum class Source : uint8_t {
+        NONE,
+        DS3231_SQW,
+        TIMER1
+    };
+
+private:
+    // DS3231 registers
+    static constexpr uint8_t REG_SECONDS = 0x00;
+    static constexpr uint8_t REG_CONTROL = 0x0E;
+    static constexpr uint8_t REG_STATUS = 0x0F;
+    static constexpr uint8_t STATUS_OSF = 0x80;  // Oscillator stopped (time lost)
+
+    static volatile uint32_t seconds_;
+    static Source source_;
+    static bool timeValid_;
+    static int32_t zoneOffset_;
+    static uint32_t lastPolled_;       // secondChanged()
+    static uint32_t calendarSecond_;   // Local second of calendar_
+    static Calendar calendar_;
+
+    static uint8_t fromBcd(uint8_t value) {
+        return (value >> 4) * 10 + (value & 0x0F);
+    }
+
+    static uint8_t toBcd(uint8_t value) {
+        return ((value / 10) << 4) | (value % 10);
+    }
+
+    static bool readRegisters(uint8_t first, uint8_t* values, uint8_t count) {
+        Wire.beginTransmission(DS3231_ADDRESS);
+        Wire.write(first);
+        if (Wire.endTransmission() != 0) {
+            return false;
+        }
+
+        if (Wire.requestFrom(DS3231_ADDRESS, count) != count) {
+            return false;
+        }
+        for (uint8_t i = 0; i < count; i++) {
+            values[i] = Wire.read();
+        }
+        return true;
+    }
+
+    static bool writeRegisters(uint8_t first, const uint8_t* values, uint8_t count) {
+        Wire.beginTransmission(DS3231_ADDRESS);
+        Wire.write(first);
+        for (uint8_t i = 0; i < count; i++) {
+            Wire.write(values[i]);
+        }
+        return Wire.endTransmission() == 0;
+    }
+
+    /**
+     * @brief Days since 1970-01-01 of a civil date (proleptic Gregorian)
+     */
+    static int32_t daysFromCivil(int16_t year, uint8_t month, uint8_t day) {
+        year -= month <= 2;
+        const int16_t era = (year >= 0 ? year : year - 399) / 400;
+        const uint16_t yearOfEra = static_cast<uint16_t>(year - era * 400);
+        const uint16_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        const uint32_t dayOfEra = yearOfEra * 365UL + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        return era * 146097L + static_cast<int32_t>(dayOfEra) - 719468L;
+    }
+
+public:
+    // ==================== SOURCES ====================
+
+    /**
+     * @brief Use a DS3231: read its time and count its 1 Hz SQW output
+     * @param sqwPin Pin with external interrupt wired to SQW (open drain)
+     * @return false if the RTC doesn't answer or the pin has no interrupt
+     */
+    static bool beginDs3231(uint8_t sqwPin) {
+        const int interrupt = digitalPinToInterrupt(sqwPin);
+        if (interrupt == NOT_AN_INTERRUPT) {
+            return false;
+        }
+
+        Wire.begin();
+
+        uint8_t status;
+        uint8_t time[7];
+        if (!readRegisters(REG_STATUS, &status, 1) || !readRegisters(REG_SECONDS, time, sizeof(time))) {
+            return false;
+        }
+
+        // SQW at 1 Hz: INTCN = 0, RS2:1 = 0
+        const uint8_t control = 0x00;
+        writeRegisters(REG_CONTROL, &control, 1);
+
+        if ((status & STATUS_OSF) == 0) {
+            Calendar utc;
+            utc.second = fromBcd(time[0] & 0x7F);
+            utc.minute = fromBcd(time[1] & 0x7F);
+            utc.hour = fromBcd(time[2] & 0x3F); // 24-hour mode (set by setTime)
+            utc.day = fromBcd(time[4] & 0x3F);
+            utc.month = fromBcd(time[5] & 0x1F);
+            utc.year = 2000 + fromBcd(time[6]);
+            seconds_ = fromCalendar(utc);
+            timeValid_ = true;
+        }
+
+        source_ = Source::DS3231_SQW;
+        pinMode(sqwPin, INPUT_PULLUP);
+        attachInterrupt(interrupt, tick, FALLING);
+        return true;
+    }
+
+    /**
+     * @brief Use Timer1 (CTC, F_CPU / 1024 / 15625 = 1 Hz at 16 MHz)
+     * Accuracy of the resonator or crystal of the board
+     */
+    static void beginTimer1() {
+        const uint8_t oldSREG = SREG;
+        cli();
+        TCCR1A = 0;
+        TCCR1B = _BV(WGM12) | _BV(CS12) | _BV(CS10);
+        OCR1A = static_cast<uint16_t>(F_CPU / 1024 - 1);
+        TCNT1 = 0;
+        TIMSK1 |= _BV(OCIE1A);
+        SREG = oldSREG;
+
+        source_ = Source::TIMER1;
+    }
+
+    static Source getSource() {
+        return source_;
+    }
+
+    /**
+     * @brief 1 Hz interrupt handler
+     */
+    static void tick() {
+        seconds_ = seconds_ + 1;
+    }
+
+    // ==================== TIME ====================
+
+    /**
+     * @brief Epoch seconds (UTC, since 1970-01-01)
+     */
+    static uint32_t now() {
+        const uint8_t oldSREG = SREG;
+        cli();
+        const uint32_t seconds = seconds_;
+        SREG = oldSREG;
+        return seconds;
+    }
+
+    /**
+     * @brief Set the time (UTC); also written in the DS3231 if used
+     */
+    static void setTime(uint32_t epochSeconds) {
+        const uint8_t oldSREG = SREG;
+        cli();
+        seconds_ = epochSeconds;
+        SREG = oldSREG;
+
+        timeValid_ = true;
+        calendarSecond_ = epochSeconds + 1; // Force a new breakdown
+
+        if (source_ == Source::DS3231_SQW) {
+            Calendar utc;
+            toCalendar(epochSeconds, utc);
+
+            const uint8_t time[7] = {
+                toBcd(utc.second), toBcd(utc.minute), toBcd(utc.hour),
+                static_cast<uint8_t>(utc.dayOfWeek + 1), toBcd(utc.day), toBcd(utc.month),
+                toBcd(static_cast<uint8_t>(utc.year % 100))
+            };
+            const uint8_t status = 0x00; // Clear OSF: the time is valid again
+            writeRegisters(REG_SECONDS, time, sizeof(time));
+            writeRegisters(REG_STATUS, &status, 1);
+        }
+    }
+
+    /**
+     * @brief false until setTime, or a DS3231 with a kept time
+     */
+    static bool isTimeValid() {
+        return timeValid_;
+    }
+
+    /**
+     * @brief Offset of the local time to UTC (e.g. -3 * 3600L for Brasília)
+     */
+    static void setTimeZone(int32_t offsetSeconds) {
+        zoneOffset_ = offsetSeconds;
+        calendarSecond_ = now() + 1;
+    }
+
+    static int32_t getTimeZone() {
+        return zoneOffset_;
+    }
+
+    /**
+     * @brief true once per new second (polled)
+     */
+    static bool secondChanged() {
+        const uint32_t seconds = now();
+        if (seconds == lastPolled_) {
+            return false;
+        }
+
+        lastPolled_ = seconds;
+        return true;
+    }
+
+    /**
+     * @brief Local date and time, computed again only if the second changed
+     */
+    static const Calendar& localTime() {
+        const uint32_t local = now() + zoneOffset_;
+
+        if (local != calendarSecond_) {
+            toCalendar(local, calendar_);
+            calendarSecond_ = local;
+        }
+        return calendar_;
+    }
+
+    // ==================== CALENDAR ====================
+
+    static bool isLeapYear(uint16_t year) {
+        return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    }
+
+    static uint8_t daysInMonth(uint8_t month, uint16_t year) {
+        static const uint8_t DAYS[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        return (month == 2 && isLeapYear(year)) ? 29 : DAYS[month - 1];
+    }
+
+    /**
+     * @brief Calendar to epoch seconds (no time zone; dayOfWeek ignored)
+     */
+    static uint32_t fromCalendar(const Calendar& calendar) {
+        const int32_t days = daysFromCivil(calendar.year, calendar.month, calendar.day);
+        return static_cast<uint32_t>(days) * 86400UL +
+               calendar.hour * 3600UL + calendar.minute * 60U + calendar.second;
+    }
+
+    /**
+     * @brief Epoch seconds to calendar (no time zone)
+     */
+    static void toCalendar(uint32_t seconds, Calendar& calendar) {
+        const uint32_t days = seconds / 86400UL;
+        uint32_t daySeconds = seconds % 86400UL;
+
+        calendar.hour = daySeconds / 3600;
+        daySeconds %= 3600;
+        calendar.minute = daySeconds / 60;
+        calendar.second = daySeconds % 60;
+        calendar.dayOfWeek = (days + 4) % 7; // 1970-01-01 was a Thursday
+
+        // Civil from days (eras of 400 years from 0000-03-01)
+        const uint32_t shifted = days + 719468UL;
+        const uint32_t era = shifted / 146097UL;
+        const uint32_t dayOfEra = shifted - era * 146097UL;
+        const uint32_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+        const uint32_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+        const uint32_t monthIndex = (5 * dayOfYear + 2) / 153; // 0 = March
+
+        calendar.day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+        calendar.month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+        calendar.year = yearOfEra + era * 400 + (calendar.month <= 2);
+    }
+};
+
+#ifdef TIMEBASE_DEFINE_STATICS
+volatile uint32_t Timebase::seconds_ = 0;
+Timebase::Source Timebase::source_ = Timebase::Source::NONE;
+bool Timebase::timeValid_ = false;
+int32_t Timebase::zoneOffset_ = 0;
+uint32_t Timebase::lastPolled_ = 0;
+uint32_t Timebase::calendarSecond_ = 0xFFFFFFFFUL;
+Calendar Timebase::calendar_ = {1970, 1, 1, 0, 0, 0, 4};
+
+#ifndef TIMEBASE_NO_TIMER1_ISR
+ISR(TIMER1_COMPA_vect) { Timebase::tick(); }
+#endif
+#endif // TIMEBASE_DEFINE_STATICS
+
+#endif // TIMEBASE_H
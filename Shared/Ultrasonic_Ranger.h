@@ -0,0 +1,289 @@
+/**
+ * @file Ultrasonic_Ranger.h
+ * @brief Non-blocking HC-SR04 ranging engine with pin change interrupts
+ * @version 1.0.0
+ *
+ * Replace the pulseIn() busy-wait (up to 30-35 ms per reading) by:
+ *  - a 10us trigger pulse fired from service()
+ *  - the echo edges timestamped in the pin change ISR (micros())
+ *  - the result delivered by a callback and/or a polled "ready" flag
+ *
+ * Several sensors are ranged one at a time in round-robin, with at least
+ * MIN_SLOT_MS between two triggers, so the echo of one sensor is never
+ * received by the next one (crosstalk). While one sensor is ranging, the
+ * loop processes the result of the previous one.
+ *
+ * Usage:
+ *   #define ULTRASONIC_RANGER_DEFINE_STATICS   // In one file of the sketch
+ *   const uint8_t sensor = UltrasonicRanger::attach(TRIG_PIN, ECHO_PIN);
+ *   UltrasonicRanger::begin(100);            // One reading each 100 ms
+ *   loop: UltrasonicRanger::service();       // Never blocks
+ *         if (UltrasonicRanger::isReady(sensor)) { ... readEchoMicros(sensor) ... }
+ *
+ * The echo pin must have a pin change interrupt (all pins of the Uno).
+ * Define ULTRASONIC_RANGER_NO_ISR to write the PCINT vectors yourself
+ * (e.g. with SoftwareSerial) and call UltrasonicRanger::handlePinChange().
+ */
+
+#ifndef ULTRASONIC_RANGER_H
+#define ULTRASONIC_RANGER_H
+
+#include <Arduino.h>
+
+#ifndef ULTRASONIC_MAX_SENSORS
+#define ULTRASONIC_MAX_SENSORS 4
+#endif
+
+/**
+ * @brief Round-robin ranging of up to ULTRASONIC_MAX_SENSORS sensors
+ *
+ * One ranging schedule for the whole sketch: static engine (see
+ * Shared/README.md).
+ */
+class UltrasonicRanger {
+public:
+    // Called from service() (not from the ISR); echoMicros = 0 on timeout
+    using ResultCallback = void (*)(uint8_t sensor, uint16_t echoMicros);
+
+    static constexpr uint8_t MAX_SENSORS = ULTRASONIC_MAX_SENSORS;
+    static constexpr uint8_t NO_SENSOR = 0xFF;
+
+    // HC-SR04 datasheet: at least 60 ms between two measurements
+    static constexpr uint16_t MIN_SLOT_MS = 60;
+
+    // Longest echo of the HC-SR04 (4 m) is ~23.5 ms
+    static constexpr uint16_t DEFAULT_TIMEOUT_US = 30000;
+
+private:
+    /**
+     * @brief Phase of the measurement in progress
+     */
+    enum class Phase : uint8_t {
+        IDLE,           // No measurement in progress
+        WAITING_ECHO,   // Trigger sent, waiting the rising edge
+        MEASURING,      // Rising edge seen, waiting the falling edge
+        DONE            // Falling edge seen, result to deliver
+    };
+
+    struct Sensor {
+        uint8_t triggerPin;
+        volatile uint8_t* echoInput; // PINx register of the echo pin
+        uint8_t echoMask;
+        uint16_t timeoutMicros;
+        uint16_t lastEchoMicros;     // Last result (0 = timeout)
+        bool ready;                  // New result not yet read
+    };
+
+    static Sensor sensors_[MAX_SENSORS];
+    static uint8_t sensorCount_;
+    static ResultCallback callback_;
+    static uint16_t slotMillis_;
+
+    // Measurement in progress (shared with the ISR)
+    static volatile Phase phase_;
+    static volatile uint32_t echoStartMicros_;
+    static volatile uint32_t echoEndMicros_;
+    static volatile uint8_t activeSensor_;
+    static uint32_t triggerMicros_;
+    static uint32_t lastTriggerMillis_;
+
+    /**
+     * @brief Enable the pin change interrupt of a pin
+     * @return false if the pin has no pin change interrupt
+     */
+    static bool enablePinChangeInterrupt(uint8_t pin) {
+        volatile uint8_t* pcmsk = digitalPinToPCMSK(pin);
+        if (pcmsk == nullptr) {
+            return false;
+        }
+
+        *pcmsk |= _BV(digitalPinToPCMSKbit(pin));
+        PCIFR = _BV(digitalPinToPCICRbit(pin)); // Discard an old pending edge
+        PCICR |= _BV(digitalPinToPCICRbit(pin));
+        return true;
+    }
+
+    static void fireTrigger(uint8_t index) {
+        const Sensor& sensor = sensors_[index];
+
+        activeSensor_ = index;
+        phase_ = Phase::WAITING_ECHO;
+
+        // 10us pulse (the only busy-wait of the engine)
+        digitalWrite(sensor.triggerPin, HIGH);
+        delayMicroseconds(10);
+        digitalWrite(sensor.triggerPin, LOW);
+
+        triggerMicros_ = micros();
+        lastTriggerMillis_ = millis();
+    }
+
+    static void deliver(uint8_t index, uint16_t echoMicros) {
+        sensors_[index].lastEchoMicros = echoMicros;
+        sensors_[index].ready = true;
+
+        if (callback_ != nullptr) {
+            callback_(index, echoMicros);
+        }
+    }
+
+public:
+    /**
+     * @brief Register a sensor (before begin)
+     * @return Index of the sensor, or NO_SENSOR if it can't be used
+     */
+    static uint8_t attach(uint8_t triggerPin, uint8_t echoPin,
+                          uint16_t timeoutMicros = DEFAULT_TIMEOUT_US) {
+        if (sensorCount_ >= MAX_SENSORS || digitalPinToPCMSK(echoPin) == nullptr) {
+            return NO_SENSOR;
+        }
+
+        pinMode(triggerPin, OUTPUT);
+        digitalWrite(triggerPin, LOW);
+        pinMode(echoPin, INPUT);
+
+        Sensor& sensor = sensors_[sensorCount_];
+        sensor.triggerPin = triggerPin;
+        sensor.echoInput = portInputRegister(digitalPinToPort(echoPin));
+        sensor.echoMask = digitalPinToBitMask(echoPin);
+        sensor.timeoutMicros = timeoutMicros;
+        sensor.lastEchoMicros = 0;
+        sensor.ready = false;
+
+        enablePinChangeInterrupt(echoPin);
+        return sensorCount_++;
+    }
+
+    /**
+     * @brief Start the ranging schedule
+     * @param periodMs Period between two readings of the same sensor
+     *        (raised to MIN_SLOT_MS per sensor)
+     */
+    static void begin(uint16_t periodMs = MIN_SLOT_MS) {
+        const uint16_t slot = sensorCount_ > 0 ? periodMs / sensorCount_ : periodMs;
+        slotMillis_ = slot < MIN_SLOT_MS ? MIN_SLOT_MS : slot;
+
+        phase_ = Phase::IDLE;
+        activeSensor_ = sensorCount_ > 0 ? sensorCount_ - 1 : 0; // Next trigger is the sensor 0
+        lastTriggerMillis_ = millis() - slotMillis_;
+    }
+
+    /**
+     * @brief Result callback (optional, the ready flag works without it)
+     */
+    static void onResult(ResultCallback callback) {
+        callback_ = callback;
+    }
+
+    /**
+     * @brief Advance the schedule: deliver results, timeouts and triggers
+     * Must be called often from the loop; never blocks (besides the 10us pulse)
+     */
+    static void service() {
+        if (sensorCount_ == 0) {
+            return;
+        }
+
+        const Phase phase = phase_;
+
+        if (phase == Phase::DONE) {
+            const uint8_t oldSREG = SREG;
+            cli();
+            const uint32_t width = echoEndMicros_ - echoStartMicros_;
+            SREG = oldSREG;
+
+            phase_ = Phase::IDLE;
+            deliver(activeSensor_, width > sensors_[activeSensor_].timeoutMicros ? 0 : static_cast<uint16_t>(width));
+        } else if (phase != Phase::IDLE &&
+                   micros() - triggerMicros_ > sensors_[activeSensor_].timeoutMicros) {
+            // No echo (or an endless one): the sensor gives nothing this slot.
+            // Atomic, so a falling edge arriving now is not lost half-way
+            const uint8_t oldSREG = SREG;
+            cli();
+            const bool timedOut = phase_ != Phase::DONE;
+            if (timedOut) {
+                phase_ = Phase::IDLE;
+            }
+            SREG = oldSREG;
+
+            if (timedOut) {
+                deliver(activeSensor_, 0);
+            }
+        }
+
+        if (phase_ == Phase::IDLE && millis() - lastTriggerMillis_ >= slotMillis_) {
+            fireTrigger((activeSensor_ + 1) % sensorCount_);
+        }
+    }
+
+    /**
+     * @brief Verify if a new result is available (polled mode)
+     */
+    static bool isReady(uint8_t sensor) {
+        return sensor < sensorCount_ && sensors_[sensor].ready;
+    }
+
+    /**
+     * @brief Read the last echo width and clear the ready flag
+     * @return Echo pulse width in microseconds, 0 on timeout
+     */
+    static uint16_t readEchoMicros(uint8_t sensor) {
+        if (sensor >= sensorCount_) {
+            return 0;
+        }
+
+        sensors_[sensor].ready = false;
+        return sensors_[sensor].lastEchoMicros;
+    }
+
+    /**
+     * @brief Pin change handler (called by the PCINT vectors)
+     * Only the echo of the active sensor is looked at
+     */
+    static void handlePinChange() {
+        const Phase phase = phase_;
+        if (phase != Phase::WAITING_ECHO && phase != Phase::MEASURING) {
+            return;
+        }
+
+        const Sensor& sensor = sensors_[activeSensor_];
+        const bool high = (*sensor.echoInput & sensor.echoMask) != 0;
+        const uint32_t now = micros();
+
+        if (high && phase == Phase::WAITING_ECHO) {
+            echoStartMicros_ = now;
+            phase_ = Phase::MEASURING;
+        } else if (!high && phase == Phase::MEASURING) {
+            echoEndMicros_ = now;
+            phase_ = Phase::DONE;
+        }
+    }
+};
+
+#ifdef ULTRASONIC_RANGER_DEFINE_STATICS
+UltrasonicRanger::Sensor UltrasonicRanger::sensors_[UltrasonicRanger::MAX_SENSORS];
+uint8_t UltrasonicRanger::sensorCount_ = 0;
+UltrasonicRanger::ResultCallback UltrasonicRanger::callback_ = nullptr;
+uint16_t UltrasonicRanger::slotMillis_ = UltrasonicRanger::MIN_SLOT_MS;
+volatile UltrasonicRanger::Phase UltrasonicRanger::phase_ = UltrasonicRanger::Phase::IDLE;
+volatile uint32_t UltrasonicRanger::echoStartMicros_ = 0;
+volatile uint32_t UltrasonicRanger::echoEndMicros_ = 0;
+volatile uint8_t UltrasonicRanger::activeSensor_ = 0;
+uint32_t UltrasonicRanger::triggerMicros_ = 0;
+uint32_t UltrasonicRanger::lastTriggerMillis_ = 0;
+
+#ifndef ULTRASONIC_RANGER_NO_ISR
+// Echo pins may be on any port: all the PCINT vectors forward to the engine
+#if defined(PCINT0_vect)
+ISR(PCINT0_vect) { UltrasonicRanger::handlePinChange(); }
+#endif
+#if defined(PCINT1_vect)
+ISR(PCINT1_vect) { UltrasonicRanger::handlePinChange(); }
+#endif
+#if defined(PCINT2_vect)
+ISR(PCINT2_vect) { UltrasonicRanger::handlePinChange(); }
+#endif
+#endif
+#endif // ULTRASONIC_RANGER_DEFINE_STATICS
+
+#endif // ULTRASONIC_RANGER_H
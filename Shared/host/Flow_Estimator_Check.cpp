@@ -0,0 +1,84 @@
+/**
+ * @file Flow_Estimator_Check.cpp
+ * @brief Host check of the FlowEstimator across the millis() overflow
+ * @version 1.0.0
+ *
+ * Feed the same draining level (one sample every 5 s, with a little
+ * noise) twice: from millis() = 0, and from just before 0xFFFFFFFF so
+ * that the window crosses the overflow. Rate and fitted value must be the
+ * same at every sample, and the final rate must be the real one.
+ *
+ * Build and run (from the repository root, with the Arduino core shim of
+ * the Semaphore_RTOS host simulation):
+ *   g++ -std=gnu++11 -O2 -Wall -I Semaphore_RTOS/host -I . \
+ *       Shared/host/Flow_Estimator_Check.cpp -o flow_estimator_check
+ *   ./flow_estimator_check
+ *
+ * Exit code is not zero if a check failed.
+ */
+
+#include <Arduino.h>
+
+#include "Shared/Flow_Estimator.h"
+
+namespace {
+
+constexpr uint8_t WINDOW = 16;
+constexpr uint32_t SAMPLE_PERIOD_MS = 5000;
+constexpr uint16_t SAMPLES = 200;
+constexpr int16_t START_LEVEL_MM = 1500;
+constexpr int32_t DRAIN_MM_PER_HOUR = 720;   // 1 mm per 5 s
+
+// Tolerated error of the final rate (noise of +-1 mm)
+constexpr int32_t MAX_RATE_ERROR = DRAIN_MM_PER_HOUR / 20;
+
+int16_t levelAt(uint16_t sample) {
+    static const int8_t NOISE[] = {0, 1, -1, 0, 1, 0, -1, 1};
+    return START_LEVEL_MM - static_cast<int16_t>(sample) + NOISE[sample % sizeof(NOISE)];
+}
+
+} // namespace
+
+int main() {
+    // Overflow after a third of the run
+    const uint32_t nearOverflow = 0xFFFFFFFFUL - (SAMPLES / 3) * SAMPLE_PERIOD_MS;
+
+    FlowEstimator<WINDOW> reference;
+    FlowEstimator<WINDOW> wrapping;
+
+    bool passed = true;
+    uint16_t mismatches = 0;
+
+    for (uint16_t i = 0; i < SAMPLES; i++) {
+        const uint32_t elapsed = static_cast<uint32_t>(i) * SAMPLE_PERIOD_MS;
+        reference.addSample(elapsed, levelAt(i));
+        wrapping.addSample(nearOverflow + elapsed, levelAt(i));
+
+        if (reference.getRatePerHour() != wrapping.getRatePerHour() ||
+            reference.getFittedValue() != wrapping.getFittedValue()) {
+            if (mismatches++ == 0) {
+                printf("[FLOW] sample %u: rate %ld / %ld, fitted %d / %d\n",
+                       static_cast<unsigned>(i),
+                       static_cast<long>(reference.getRatePerHour()),
+                       static_cast<long>(wrapping.getRatePerHour()),
+                       reference.getFittedValue(), wrapping.getFittedValue());
+            }
+        }
+    }
+
+    const int32_t rate = wrapping.getRatePerHour();
+    const int32_t error = rate + DRAIN_MM_PER_HOUR;
+    const bool rateOk = error <= MAX_RATE_ERROR && error >= -MAX_RATE_ERROR;
+    passed = mismatches == 0 && rateOk;
+
+    printf("[FLOW] start %lu: %u samples, %u mismatches, rate %ld mm/h (expected %ld): %s\n",
+           static_cast<unsigned long>(nearOverflow),
+           static_cast<unsigned>(SAMPLES),
+           static_cast<unsigned>(mismatches),
+           static_cast<long>(rate),
+           static_cast<long>(-DRAIN_MM_PER_HOUR),
+           passed ? "OK" : "FAIL");
+
+    printf("%s\n", passed ? "ALL CHECKS PASSED" : "SOME CHECKS FAILED");
+    return passed ? 0 : 1;
+}
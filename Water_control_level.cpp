@@ -12,8 +12,37 @@
 
 #include <LiquidCrystal.h>
 
+// Quadro do LCD em RAM: só os caracteres alterados são enviados
+#include "Shared/Lcd_Framebuffer.h"
+
+// Barra de nível com caracteres parciais (5 colunas por célula)
+#include "Shared/Lcd_Bar_Graph.h"
+
+// Vazão por mínimos quadrados e previsão de tempo para esvaziar/encher
+#include "Shared/Flow_Estimator.h"
+
+// Medição ultrassônica sem bloqueio (eco medido por interrupção)
+#define ULTRASONIC_RANGER_DEFINE_STATICS
+#include "Shared/Ultrasonic_Ranger.h"
+
+// Conversões em ponto fixo (sem float no AVR, que não tem FPU)
+#include "Shared/Fixed_Point.h"
+
+// Alarmes com histerese e LED piscando pelo Timer2 (sem millis() no loop)
+#define ALARM_ENGINE_DEFINE_STATICS
+#include "Shared/Alarm_Engine.h"
+
+// Tarefas periódicas cooperativas (sem delay(), CPU dormindo entre prazos)
+#include "Shared/Cooperative_Scheduler.h"
+
+// Medidas de tempo (ciclos do Timer1) com histograma, relatório no serial
+#define PERF_PROBE_DEFINE_STATICS
+#include "Shared/Perf_Probe.h"
+
 // Configuração dos pinos do LCD
 LiquidCrystal lcd(2, 3, 4, 5, 6, 7);
+LcdFramebuffer<LiquidCrystal, 16, 2> tela(lcd); // Sem lcd.clear() a cada atualização
+LcdBarGraph<6> barraNivel(1000); // 6 células = 30 passos para 0 a 1000 por mil
 
 // Definição dos pinos
 const int trigPin = 8;
@@ -22,32 +51,72 @@ const int buttonPin = 10;
 const int switchPin = 11;
 const int ledPin = 12;
 
-// Configurações do reservatório (em cm)
-const float alturaReservatorio = 100.0; // Altura total do reservatório
-const float nivelMinimo = 20.0; // Nível mínimo (20%)
-const float nivelCritico = 10.0; // Nível crítico (10%)
+// Configurações do reservatório (distâncias em mm, percentuais em por mil)
+const uint16_t alturaReservatorio = 1000; // Altura total do reservatório (100 cm)
+const uint16_t nivelMinimo = 200; // Nível mínimo (20%)
+const uint16_t nivelCritico = 100; // Nível crítico (10%)
+const uint16_t nivelCheio = 900; // Nível cheio (90%)
+
+// Nível -> por mil com o recíproco da altura pré-calculado (sem divisão)
+const FixedPoint::PerMilleScale escalaNivel(alturaReservatorio);
+
+// Alarmes de nível: ativados abaixo do limite, desligados 2% acima, após 1 s
+const uint16_t histereseNivel = 20;
+const uint16_t tempoConfirmacao = 1000;
+HysteresisAlarm alarmeCritico(nivelCritico, nivelCritico + histereseNivel, tempoConfirmacao,
+                              HysteresisAlarm::Direction::BELOW);
+HysteresisAlarm alarmeBaixo(nivelMinimo, nivelMinimo + histereseNivel, tempoConfirmacao,
+                            HysteresisAlarm::Direction::BELOW);
+
+// Estimativa de vazão: 16 amostras a cada 5 s (janela de 80 s)
+const uint16_t periodoVazao = 5000;
+const int16_t vazaoMinima = 20; // Abaixo de 20 mm/h o nível é considerado estável
+const int32_t antecedenciaCritico = 60; // Alarme crítico 60 s antes de atingir o nível
+const uint16_t nivelCriticoMm = (uint32_t)alturaReservatorio * nivelCritico / 1000;
+const uint16_t nivelCheioMm = (uint32_t)alturaReservatorio * nivelCheio / 1000;
+FlowEstimator<16> estimadorVazao(vazaoMinima);
+
+// Padrões do LED (16 passos por ciclo)
+const AlarmPattern sinalCritico[] = {{0x0000, 0xCCCC, 100, 0}}; // Pisca rápido (200ms)
+const AlarmPattern sinalBaixo[] = {{0x0000, 0x0F0F, 125, 0}};   // Pisca lento (500ms)
 
 // Variáveis de controle
-float distancia = 0;
-float nivelAgua = 0;
-float percentualAgua = 0;
+uint16_t distancia = 0; // mm
+uint16_t nivelAgua = 0; // mm
+uint16_t percentualAgua = 0; // por mil (0 a 1000)
 bool sistemaLigado = false;
 bool buttonState = false;
 bool lastButtonState = false;
 bool modoDetalhado = false;
-unsigned long lastUpdate = 0;
-const unsigned long updateInterval = 500; // Atualiza a cada 500ms
+const uint16_t updateInterval = 500; // Atualiza a cada 500ms
+const uint16_t periodoEntradas = 25; // Entradas amostradas a cada 25ms (debounce sem delay)
+
+// Medição ultrassônica
+const uint16_t timeoutEco = 30000; // Timeout do eco em us (30ms)
+const uint16_t periodoMedicao = 100; // Uma medição a cada 100ms
+uint8_t sensorNivel = UltrasonicRanger::NO_SENSOR; // Índice do sensor no motor de medição
+
+// Tarefas: medição (a cada passada), entradas, atualização, amostra de vazão
+// e relatório de desempenho
+CooperativeScheduler<5> agenda;
+uint8_t tarefaAtualizacao = CooperativeScheduler<5>::INVALID_JOB;
+
+// Medidas: período do loop (jitter), atualização completa e só o display
+const uint16_t periodoRelatorio = 10000;
+uint8_t medidaLoop = PerfProbe::INVALID_PROBE;
+uint8_t medidaAtualizacao = PerfProbe::INVALID_PROBE;
+uint8_t medidaDisplay = PerfProbe::INVALID_PROBE;
 
 void setup() {
     // Inicializa o LCD
     lcd.begin(16, 2);
+    barraNivel.loadGlyphs(lcd); // Caracteres parciais na CGRAM (uma vez)
 
     // Configuração dos pinos
-    pinMode(trigPin, OUTPUT);
-    pinMode(echoPin, INPUT);
+    sensorNivel = UltrasonicRanger::attach(trigPin, echoPin, timeoutEco);
     pinMode(buttonPin, INPUT_PULLUP);
     pinMode(switchPin, INPUT_PULLUP);
-    pinMode(ledPin, OUTPUT);
+    AlarmSignal::begin(AlarmSignal::NO_PIN, ledPin); // Só o LED (sem buzzer)
 
     // Mensagem inicial
     lcd.clear();
@@ -58,145 +127,236 @@ void setup() {
     delay(2000);
 
     Serial.begin(9600);
+
+    // Inicia as medições em segundo plano
+    UltrasonicRanger::begin(periodoMedicao);
+
+    // Tarefas (a atualização pode ser antecipada por uma mudança nas entradas)
+    agenda.addPolled(UltrasonicRanger::service); // Avança a medição (nunca bloqueia)
+    agenda.addPeriodic(lerEntradas, periodoEntradas);
+    tarefaAtualizacao = agenda.addPeriodic(atualizarSistema, updateInterval);
+    agenda.addPeriodic(amostrarVazao, periodoVazao);
+    agenda.addPeriodic(relatorioDesempenho, periodoRelatorio);
+
+    PerfProbe::begin();
+    medidaLoop = PerfProbe::define(F("loop"));
+    medidaAtualizacao = PerfProbe::define(F("atualizacao"));
+    medidaDisplay = PerfProbe::define(F("display"));
 }
 
 void loop() {
+    PerfProbe::mark(medidaLoop);
+
+    // Executa as tarefas vencidas e dorme até a próxima interrupção
+    agenda.run();
+    agenda.idle();
+}
+
+void lerEntradas() {
     // Verifica o estado do slide switch
-    sistemaLigado = !digitalRead(switchPin); // Invertido por usar INPUT_PULLUP
+    const bool ligado = !digitalRead(switchPin); // Invertido por usar INPUT_PULLUP
+    bool mudou = ligado != sistemaLigado;
+    sistemaLigado = ligado;
 
-    // Verifica o botão (para alternar modo de visualização)
+    // Verifica o botão (para alternar modo de visualização); amostrado a
+    // cada 25ms, o repique do contato não gera uma segunda borda
     buttonState = !digitalRead(buttonPin);
     if (buttonState && !lastButtonState){
         modoDetalhado = !modoDetalhado;
-        delay(200); // Debounce
+        mudou = true;
     }
     lastButtonState = buttonState;
 
+    // Mostra a mudança já, sem esperar o próximo intervalo
+    if (mudou){
+        agenda.trigger(tarefaAtualizacao);
+    }
+}
+
+void atualizarSistema() {
+    PerfScope medida(medidaAtualizacao);
+
     // Se o sistema estiver desligado
     if (!sistemaLigado){
-        lcd.clear();
-        lcd.setCursor(0, 1);
-        lcd.print("Sistema");
-        lcd.setCursor(0, 1);
-        lcd.print("DESLIGADO");
-        digitalWrite(ledPin, LOW);
-        delay(500);
+        tela.clear();
+        tela.setCursor(0, 0);
+        tela.print("Sistema");
+        tela.setCursor(0, 1);
+        tela.print("DESLIGADO");
+        tela.flush();
+        AlarmSignal::stop();
+        alarmeCritico.reset();
+        alarmeBaixo.reset();
+        estimadorVazao.reset();
         return;
     }
 
-    // Atualiza leituras a cada intervalo definido
-    if (millis() - lastUpdate >= updateInterval){
-        lastUpdate = millis();
+    // Última distância medida pelo sensor ultrassônico
+    distancia = medirDistancia();
 
-        // Mede a distância com o sensor ultrassônico
-        distancia = medirDistancia();
+    // Calcula o nível da água (limitado a 0)
+    nivelAgua = distancia < alturaReservatorio ? alturaReservatorio - distancia : 0;
 
-        // Calcula o nível da água
-        nivelAgua = alturaReservatorio - distancia;
-        if (nivelAgua < 0) nivelAgua = 0;
-        if (nivelAgua > alturaReservatorio) nivelAgua = alturaReservatorio;
+    // Calcula o percentual (por mil, saturado em 1000)
+    percentualAgua = escalaNivel.apply(nivelAgua);
 
-        // Calcula o percentual
-        percentualAgua = (nivelAgua / alturaReservatorio) * 100.0;
+    // Controla o LED de alerta
+    controleLED();
 
-        // Controla o LED de alerta
-        controleLED();
+    // Atualiza o display
+    atualizarDisplay();
 
-        // Atualiza o display
-        atualizarDisplay();
+    // Debug via Serial
+    Serial.print("Distancia: ");
+    FixedPoint::printFixed(Serial, distancia, 1);
+    Serial.print(" cm | Nivel: ");
+    FixedPoint::printFixed(Serial, nivelAgua, 1);
+    Serial.print(" cm | Percentual: ");
+    FixedPoint::printFixed(Serial, percentualAgua, 1);
+    Serial.print(" % | Vazao: ");
+    Serial.print(estimadorVazao.getRatePerHour());
+    Serial.println(" mm/h");
+}
 
-        // Debug via Serial
-        Serial.print("Distancia: ");
-        Serial.print(distancia);
-        Serial.print(" cm | Nivel: ");
-        Serial.print(nivelAgua);
-        Serial.print(" cm | Percentual: ");
-        Serial.print(percentualAgua);
-        Serial.println(" %");
-    }
+void relatorioDesempenho() {
+    // Mín/méd/máx e histograma de cada medida nos últimos 10 s
+    PerfProbe::dump(Serial);
+    Serial.print("Atrasos da atualizacao: ");
+    Serial.println(agenda.getOverruns(tarefaAtualizacao));
 }
 
-float medirDistancia() {
-    // Limpa o trigger
-    digitalWrite(trigPin, LOW);
-    delayMicroseconds(2);
+void amostrarVazao() {
+    // Amostra para a estimativa de vazão (O(1) por amostra)
+    if (sistemaLigado){
+        estimadorVazao.addSample(millis(), nivelAgua);
+    }
+}
 
-    // Envia o pulso de 10us
-    digitalWrite(trigPin, HIGH);
-    delayMicroseconds(10);
-    digitalWrite(trigPin, LOW);
+uint16_t medirDistancia() {
+    // Sem leitura nova, mantém a última
+    if (!UltrasonicRanger::isReady(sensorNivel)){
+        return distancia;
+    }
 
-    // Lê o tempo de retorno do pulso
-    long duracao = pulseIn(echoPin, HIGH, 30000); // Timeout de 30ms
+    // Tempo de retorno do pulso (0 em caso de timeout)
+    uint16_t duracao = UltrasonicRanger::readEchoMicros(sensorNivel);
 
-    // Calcula a distância
-    float dist = duracao * 0.0343 / 2.0;
+    // Calcula a distância em mm (multiplicação e deslocamento)
+    uint16_t dist = FixedPoint::echoMicrosToMillimeters(duracao);
 
-    // Limita valores inválidos
-    if (dist > 400 || dist < 2){
+    // Limita valores inválidos (2 cm a 400 cm)
+    if (dist > 4000 || dist < 20){
         return distancia; // Retorna a última leitura válida
     }
 
     return dist;
 }
 
+bool nivelCriticoAtivo() {
+    // Crítico atingido, ou previsto para o próximo minuto (esvaziando)
+    const int32_t tempoCritico = estimadorVazao.secondsToReach(nivelCriticoMm);
+    return alarmeCritico.isActive() ||
+           (tempoCritico != FlowEstimator<16>::NOT_APPROACHING && tempoCritico <= antecedenciaCritico);
+}
+
+void imprimirDuracao(Print& saida, int32_t segundos) {
+    // "1h05m" acima de uma hora, senão "12m34s" ("--" se não se aproxima)
+    if (segundos < 0){
+        saida.print("--");
+    }
+    else if (segundos >= 3600){
+        saida.print(segundos / 3600);
+        saida.print('h');
+        segundos = (segundos % 3600) / 60;
+        if (segundos < 10) saida.print('0');
+        saida.print(segundos);
+        saida.print('m');
+    }
+    else{
+        saida.print(segundos / 60);
+        saida.print('m');
+        segundos %= 60;
+        if (segundos < 10) saida.print('0');
+        saida.print(segundos);
+        saida.print('s');
+    }
+}
+
 void controleLED() {
-    // LED piscando rápido se nível crítico
-    if (percentualAgua <= nivelCritico){
-        digitalWrite(ledPin, (millis() / 500) % 2); // Pisca rápido (200ms)
+    alarmeCritico.update(percentualAgua);
+    alarmeBaixo.update(percentualAgua);
+
+    // LED piscando rápido se nível crítico (ou previsto)
+    if (nivelCriticoAtivo()){
+        AlarmSignal::play(sinalCritico, 1);
     }
 
     // LED piscando lento se nível baixo
-    else if (percentualAgua <= nivelMinimo){
-        digitalWrite(ledPin, (millis() / 200) % 2); // Piscando lento (500ms)
+    else if (alarmeBaixo.isActive()){
+        AlarmSignal::play(sinalBaixo, 1);
     }
 
     // LED se apagando se nível OK
     else{
-        digitalWrite(ledPin, LOW);
+        AlarmSignal::stop();
     }
 }
 
 void atualizarDisplay() {
-    lcd.clear();
+    PerfScope medida(medidaDisplay);
+
+    tela.clear();
 
     if (!modoDetalhado){
         // Modo simples - mostra percentual e status
-        lcd.setCursor(0, 0);
-        lcd.print("Nível: ");
-        lcd.print(percentualAgua, 1);
-        lcd.print("%");
-
-        lcd.setCursor(0, 1);
-        if (percentualAgua <= nivelCritico){
-            lcd.print("CRITICO!");
+        tela.setCursor(0, 0);
+        tela.print("Nível: ");
+        FixedPoint::printFixed(tela, percentualAgua, 1);
+        tela.print("%");
+
+        tela.setCursor(0, 1);
+        if (nivelCriticoAtivo()){
+            tela.print("CRITICO!");
         }
-        else if (percentualAgua <= nivelMinimo){
-            lcd.print("BAIXO!");
+        else if (alarmeBaixo.isActive()){
+            tela.print("BAIXO!");
         }
-        else if (percentualAgua >= 90){
-            lcd.print("CHEIO!");
+        else if (percentualAgua >= nivelCheio){
+            tela.print("CHEIO!");
         }
         else{
-            lcd.print("NIVEL NORMAL");
+            tela.print("NORMAL"); // A barra ocupa as colunas 10 a 15
         }
 
-        // Barra de nível visual
-        int barras = map(percentualAgua, 0, 100, 0, 6);
-        lcd.setCursor(10, 1);
-        for (int i = 0; i < barras; i++){
-            lcd.write(255); // Caractere sólido
-        } 
+        // Barra de nível visual (só a célula que mudou é enviada)
+        barraNivel.draw(tela, 10, 1, percentualAgua);
     }
     else{
-        // Modo detalhado - mostra medidas
-        lcd.setCursor(0, 0);
-        lcd.print("Dist:");
-        lcd.print(distancia, 1);
-        lcd.print("cm");
-        lcd.setCursor(0, 1);
-        lcd.print("Agua:");
-        lcd.print(nivelAgua, 1);
-        lcd.print("cm");
+        // Modo detalhado - mostra medidas (cm) e a previsão
+        tela.setCursor(0, 0);
+        tela.print("D:");
+        FixedPoint::printFixed(tela, distancia, 1);
+        tela.print(" A:");
+        FixedPoint::printFixed(tela, nivelAgua, 1);
+
+        tela.setCursor(0, 1);
+        const int32_t vazao = estimadorVazao.getRatePerHour();
+        if (!estimadorVazao.isValid()){
+            tela.print("Medindo vazao...");
+        }
+        else if (vazao < 0){
+            tela.print("Vazio em ");
+            imprimirDuracao(tela, estimadorVazao.secondsToReach(0));
+        }
+        else if (vazao > 0){
+            tela.print("Cheio em ");
+            imprimirDuracao(tela, estimadorVazao.secondsToReach(nivelCheioMm));
+        }
+        else{
+            tela.print("Nivel estavel");
+        }
     }
+
+    // Envia só as diferenças para o LCD
+    tela.flush();
 }
\ No newline at end of file